@@ -0,0 +1,79 @@
+﻿#pragma once
+#ifndef SNAKE_ALIASTABLE_HEADER_
+#define SNAKE_ALIASTABLE_HEADER_
+
+#include "FastRandom.h"
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+// Weighted random index in O(1) by Walker's alias method (Vose's construction).
+// Building costs O(n), so keep the table as long as the weights hold.
+class AliasTable
+{
+public:
+	AliasTable() = default;
+	explicit AliasTable(std::span<const uint64_t> weights)
+		: thresholds(weights.size()), aliases(weights.size())
+	{
+		const size_t count = weights.size();
+		double total = 0;
+		for (auto weight : weights)
+			total += static_cast<double>(weight);
+		assert(total > 0);
+
+		// each column holds count/total of the whole, split between itself and an alias
+		std::vector<double> scaled(count);
+		std::vector<uint32_t> small, large;
+		for (size_t i = 0; i < count; i++)
+		{
+			scaled[i] = static_cast<double>(weights[i]) * count / total;
+			(scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+		}
+		while (!small.empty() && !large.empty())
+		{
+			auto less = small.back(), more = large.back();
+			small.pop_back();
+			thresholds[less] = ToThreshold(scaled[less]);
+			aliases[less] = more;
+			scaled[more] -= 1.0 - scaled[less];
+			if (scaled[more] < 1.0)
+			{
+				large.pop_back();
+				small.push_back(more);
+			}
+		}
+		// the rest are full up to rounding errors
+		for (auto i : small)
+			thresholds[i] = FullThreshold, aliases[i] = i;
+		for (auto i : large)
+			thresholds[i] = FullThreshold, aliases[i] = i;
+	}
+
+public:
+	size_t size() const noexcept
+	{
+		return thresholds.size();
+	}
+	size_t operator()(FastRandom& engine) const noexcept
+	{
+		assert(size() != 0);
+		auto column = engine.bounded(static_cast<uint32_t>(size()));
+		return (engine() >> 32) < thresholds[column] ? column : aliases[column];
+	}
+
+private:
+	static constexpr uint64_t FullThreshold = uint64_t{ 1 } << 32;
+	static uint64_t ToThreshold(double probability) noexcept
+	{
+		return static_cast<uint64_t>(probability * static_cast<double>(FullThreshold));
+	}
+
+private:
+	std::vector<uint64_t> thresholds; // the column stays itself below, of 2^32
+	std::vector<uint32_t> aliases;
+};
+
+#endif // SNAKE_ALIASTABLE_HEADER_
\ No newline at end of file
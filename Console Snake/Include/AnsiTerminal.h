@@ -0,0 +1,38 @@
+﻿#pragma once
+#ifndef SNAKE_ANSITERMINAL_HEADER_
+#define SNAKE_ANSITERMINAL_HEADER_
+
+#include "Terminal.h"
+#include <string>
+#include <optional>
+#include <cstdint>
+
+// POSIX terminal driven by VT sequences. Everything is buffered and
+// written to the file descriptor as UTF-8 in one go on flush(),
+// or appended to a string for the owner to send, e.g. to a socket.
+class AnsiTerminal :public Terminal
+{
+public:
+	explicit AnsiTerminal(int output_fd = 1) noexcept;
+	explicit AnsiTerminal(std::string& output) noexcept;
+	~AnsiTerminal() noexcept;
+
+public:
+	void setColor(uint16_t attribute) override;
+	void setCursor(short column, short row) override;
+	void write(std::wstring_view str) override;
+	void setCursorVisible(bool visible) override;
+	void setTitle(std::wstring_view title) override;
+	void resize(short columns, short rows) override;
+	void clear() override;
+	void flush() override;
+
+private:
+	int output_fd;
+	std::string* output = nullptr;
+	std::wstring buffer;
+	std::string encoded;
+	std::optional<uint16_t> current_color;
+};
+
+#endif // SNAKE_ANSITERMINAL_HEADER_
\ No newline at end of file
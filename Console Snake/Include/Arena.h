@@ -2,133 +2,57 @@
 #ifndef SNAKE_ARENA_HEADER_
 #define SNAKE_ARENA_HEADER_
 
+#include "Venue.h"
 #include "Canvas.h"
-#include "DynArray.h"
 #include "Resource.h"
-#include <atomic>
-#include <optional>
+#include "SpscQueue.h"
+#include "Replay.h"
+#include "BotSession.h"
+#include "FrameExport.h"
+#include <chrono>
 #include <cstdint>
-#include <cstddef>
 
-struct Direction
+struct InputEvent
 {
-	enum Tags
-	{
-		None = 0,
-		Up = 1,
-		Left = 2,
-		Right = 3,
-		Down = 4,
-		Conflict = 5,
-	};
-
-	constexpr Direction() noexcept :value(None) {}
-	constexpr Direction(Tags tag) noexcept :value(tag) {}
-
-	friend constexpr bool operator==(Direction, Direction) = default;
-	friend constexpr Tags operator+(Direction direction) noexcept // for twice type conversion
-	{
-		return direction.value;
-	}
-	friend constexpr Direction operator+(Tags tag) noexcept // for twice type conversion
-	{
-		return tag;
-	}
-	friend constexpr Direction operator-(Direction direction) noexcept
-	{
-		return Tags(Direction::Conflict - direction.value);
-	}
-
-	constexpr bool isConflictWith(Direction other) const noexcept
-	{
-		return this->value + other.value == Conflict;
-	}
-
-private:
-	Tags value;
-};
-
-struct MapNode
-{
-	Element type;
-	int16_t snake_index = -1;
-};
-
-struct PosNode
-{
-	uint8_t x;
-	uint8_t y;
-};
-
-struct PosNodeGroup
-{
-	size_t count;
-	PosNode head_pos;
-	PosNode tail_pos;
-};
-
-class Venue
-{
-	static constexpr int SnakeIntendedInitLength = 3;
-public:
-	Venue(DynArray<MapNode, 2> map);
-
-public:
-	PosNode getNextPosition() const noexcept;
-	Element getPositionType(uint8_t x, uint8_t y) const noexcept;
-	const DynArray<MapNode, 2>& getCurrentMap() const noexcept;
-
-protected:
-	std::optional<PosNode> generateFood();
-
-	void orderDirection(Direction) noexcept;
-	PosNodeGroup updateFrame() noexcept;
-
-	bool isWin(size_t score) const noexcept;
-
-private:
-	void setupInvariant() noexcept;
-	void createSnake();
-	void addSnakeBody(Direction head_direct, uint8_t head_x, uint8_t head_y) noexcept;
-	void addSnakeBody(Direction tail_direct) noexcept;
-	void rebindData(int16_t snake_index, int8_t map_x, int8_t map_y) noexcept;
-	void forwardIndex(int16_t& index) const noexcept;
-	void backwardIndex(int16_t& index) const noexcept;
-	void nextPosition(uint8_t& x, uint8_t& y, Direction) const noexcept;
-
-private:
-	// The invariant of this class is that ALL map nodes except barrier
-	// and snake_body nodes should have one-to-one correspondence.
-	DynArray<MapNode, 2> map; // map[y][x]
-	DynArray<PosNode> snake_body;
-	int16_t snake_head_index = -1;
-	int16_t snake_tail_index = -1;
-	size_t snake_init_length = 0;
-
-	Direction snake_direct = Direction::None;
+	Direction direction;
+	std::chrono::steady_clock::time_point time;
 };
 
 class Arena :public Venue
 {
+	static constexpr size_t InputQueueCapacity = 16;
+	// turns pressed longer ago are not what the player means now
+	static constexpr std::chrono::milliseconds InputExpiry{ 1000 };
+
 public:
 	Arena(Canvas& canvas);
 
 public:
+	// called by the input thread only
+	void pushInput(Direction direction) noexcept;
+	// the bot decides the directions instead of the input thread while it is connected
+	void attachBot(BotSession& session);
+	// frames are published to viewers in other processes as well
+	void attachExporter(FrameExporter& exporter) noexcept;
 	void updateFrame();
 	void paintElement(Element, uint8_t x, uint8_t y);
 	bool isOver() const noexcept;
 	bool isWin() const noexcept;
+	const Replay& getReplay() const noexcept;
 
 private:
-	void paintElement(Element);
+	Arena(Canvas& canvas, DynArray<MapNode, 2> map, uint64_t seed);
+	void drawElement(Element, uint8_t x, uint8_t y) noexcept;
 	void paintVenue();
 	void generateFood();
-
-public:
-	std::atomic<Direction> input_key = +Direction::None;
+	Direction popLegalInput() noexcept;
 
 private:
+	SpscQueue<InputEvent, InputQueueCapacity> input_queue;
 	Canvas& canvas;
+	ReplayRecorder recorder;
+	BotSession* bot = nullptr;
+	FrameExporter* exporter = nullptr;
 	bool game_over = false;
 };
 
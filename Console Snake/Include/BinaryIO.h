@@ -0,0 +1,28 @@
+﻿#pragma once
+#ifndef SNAKE_BINARYIO_HEADER_
+#define SNAKE_BINARYIO_HEADER_
+
+#include <istream>
+#include <ostream>
+#include <concepts>
+#include <cstdint>
+#include <cstddef>
+
+// Fixed-width integers in little-endian, independent of the platform.
+template<std::unsigned_integral T>
+inline void WriteInteger(std::ostream& out, T value)
+{
+	for (size_t i = 0; i < sizeof(T); i++)
+		out.put(static_cast<char>(value >> (i * 8) & 0xFF));
+}
+
+template<std::unsigned_integral T>
+inline T ReadInteger(std::istream& in)
+{
+	T value = 0;
+	for (size_t i = 0; i < sizeof(T); i++)
+		value |= static_cast<T>(static_cast<uint8_t>(in.get())) << (i * 8);
+	return value;
+}
+
+#endif // SNAKE_BINARYIO_HEADER_
\ No newline at end of file
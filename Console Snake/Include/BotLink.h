@@ -0,0 +1,23 @@
+﻿#pragma once
+#ifndef SNAKE_BOTLINK_HEADER_
+#define SNAKE_BOTLINK_HEADER_
+
+#include "Interface.h"
+#include <string>
+#include <string_view>
+#include <chrono>
+
+// Byte stream to a bot process, see BotSession.
+// Implemented by PosixBotLink and WinBotLink.
+class BotLink :public Interface
+{
+public:
+	// Returns after all the data is written, waiting until the deadline for the bot to take it.
+	// Throws RuntimeException if the bot is gone or hasn't taken it in time.
+	virtual void send(std::string_view data, std::chrono::steady_clock::time_point deadline) = 0;
+	// Append the bytes received to buffer, waiting until the deadline for at least one byte.
+	// Returns false if nothing came in time, throws RuntimeException if the bot is gone.
+	virtual bool receive(std::string& buffer, std::chrono::steady_clock::time_point deadline) = 0;
+};
+
+#endif // SNAKE_BOTLINK_HEADER_
\ No newline at end of file
@@ -0,0 +1,76 @@
+﻿#pragma once
+#ifndef SNAKE_BOTSESSION_HEADER_
+#define SNAKE_BOTSESSION_HEADER_
+
+#include "Interface.h"
+#include "Venue.h"
+#include "BotLink.h"
+#include <memory>
+#include <optional>
+#include <string>
+#include <chrono>
+#include <cstddef>
+
+struct BotStats
+{
+	size_t moves = 0;
+	size_t late = 0; // no reply by the deadline
+	// time the game waited for replies, replies which were there when needed count 0
+	std::chrono::microseconds total_wait{};
+	std::chrono::microseconds max_wait{};
+};
+
+// A bot process plays the game through a line protocol over a BotLink.
+// The observation of a frame is sent as soon as the frame is updated, so the bot
+// thinks while the game renders and waits for the next tick. A reply which doesn't
+// come by the deadline counts as Direction::None (keep direction), and is dropped.
+// A bot which doesn't take an observation within the deadline either is dropped.
+//
+// Text lines, numbers in decimal, coordinates as x then y, -1 -1 for no node:
+// game -> bot
+//     snake <protocol version> <height> <width> <deadline in microseconds>
+//     map <height * width characters row by row, '#' for barriers, '.' otherwise>
+//     start <direction> <food x y> <length> <x y of each node, from the head to the tail>
+//     frame <frame> <head x y> <node x y left by the tail, or -1 -1 if grown> <food x y>
+//     over <score> <1 if won, otherwise 0>
+// bot -> game, for the observation of <frame> (start is frame 0)
+//     <frame> <direction>
+// where a direction is one of U, D, L, R and N (none).
+class BotSession :NotCopyable
+{
+public:
+	static constexpr int ProtocolVersion = 1;
+
+public:
+	BotSession(std::unique_ptr<BotLink> link, std::chrono::microseconds deadline);
+
+public:
+	// The bot is told the map and the snake, as placed by a venue which has played no frame.
+	void start(const Venue& venue);
+	// the direction of the bot for the next frame
+	Direction awaitMove() noexcept;
+	// after an update of the venue which didn't end the game, and the food generated by it
+	void sendFrame(const Venue& venue, PosNodeGroup frame);
+	void finish(size_t score, bool win);
+
+	// false after the bot is gone, then all moves are Direction::None
+	bool isConnected() const noexcept;
+	const BotStats& getStats() const noexcept;
+
+private:
+	void sendLine() noexcept;
+	// the reply to the last observation from the lines received, dropping older ones
+	std::optional<Direction> takeReply() noexcept;
+
+private:
+	std::unique_ptr<BotLink> link;
+	std::chrono::microseconds deadline;
+	size_t frame = 0; // of the last observation sent
+	std::chrono::steady_clock::time_point sent_time;
+	std::string line;
+	std::string received;
+	bool connected = true;
+	BotStats stats;
+};
+
+#endif // SNAKE_BOTSESSION_HEADER_
\ No newline at end of file
@@ -5,8 +5,10 @@
 #include "Resource.h"
 #include "WinHeader.h"
 #include "Interface.h"
+#include "FrameBuffer.h"
 #include <string_view>
 #include <stack>
+#include <string>
 
 struct Cursor
 {
@@ -69,6 +71,12 @@ public:
 	void nextLine();
 	void clear() noexcept;
 
+	// Buffered drawing: cells are drawn relative to the cursor offset,
+	// and shown together on present() in a single console write.
+	void setBufferSize(short width, short height);
+	void draw(short x, short y, wchar_t glyph, Color color) noexcept;
+	void present();
+
 public:
 	ClientSize getClientSize() const noexcept;
 	Color getColor() const noexcept;
@@ -86,6 +94,8 @@ private:
 	Cursor offset;
 	std::stack<Cursor> offset_stack;
 	ClientSize size = { 45, 35 };
+	FrameBuffer frame;
+	std::wstring present_buffer;
 };
 
 #endif // SNAKE_CANVAS_HEADER_
\ No newline at end of file
@@ -0,0 +1,252 @@
+﻿#pragma once
+#ifndef SNAKE_CELLSTORAGE_HEADER_
+#define SNAKE_CELLSTORAGE_HEADER_
+
+#include "Element.h"
+#include "DynArray.h"
+#include "Exception.h"
+#include <span>
+#include <array>
+#include <algorithm>
+#include <concepts>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+struct MapNode
+{
+	Element type;
+	int16_t snake_index = -1;
+};
+static_assert(sizeof(MapNode) == 4);
+
+// How BasicVenue stores map nodes: the element of each node, and its index in the snake ring.
+// save() and load() copy all nodes to and from getByteSize() bytes for snapshots.
+template<typename T>
+concept CellStorage = std::constructible_from<T, const DynArray<MapNode, 2>&> &&
+	requires(T cells, const T const_cells, size_t x, size_t y, Element type, int16_t index,
+			 std::span<std::byte> out, std::span<const std::byte> in)
+{
+	{ const_cells.height() } -> std::same_as<size_t>;
+	{ const_cells.width() } -> std::same_as<size_t>;
+	{ const_cells.getType(x, y) } -> std::same_as<Element>;
+	{ const_cells.getIndex(x, y) } -> std::same_as<int16_t>;
+	cells.setType(x, y, type);
+	cells.setIndex(x, y, index);
+	{ const_cells.getByteSize() } -> std::same_as<size_t>;
+	const_cells.save(out);
+	cells.load(in);
+};
+
+// Array of structures, one MapNode of 4 bytes per node. The default of Venue.
+class PackedCells
+{
+public:
+	explicit PackedCells(const DynArray<MapNode, 2>& map)
+		: nodes(map)
+	{}
+
+public:
+	size_t height() const noexcept
+	{
+		return nodes.size(0);
+	}
+	size_t width() const noexcept
+	{
+		return nodes.size(1);
+	}
+	Element getType(size_t x, size_t y) const noexcept
+	{
+		return nodes[y][x].type;
+	}
+	int16_t getIndex(size_t x, size_t y) const noexcept
+	{
+		return nodes[y][x].snake_index;
+	}
+	void setType(size_t x, size_t y, Element type) noexcept
+	{
+		nodes[y][x].type = type;
+	}
+	void setIndex(size_t x, size_t y, int16_t index) noexcept
+	{
+		nodes[y][x].snake_index = index;
+	}
+	const DynArray<MapNode, 2>& getNodes() const noexcept
+	{
+		return nodes;
+	}
+
+	size_t getByteSize() const noexcept
+	{
+		return nodes.total_size() * sizeof(MapNode);
+	}
+	void save(std::span<std::byte> out) const noexcept
+	{
+		assert(out.size() == getByteSize());
+		std::memcpy(out.data(), nodes.data(), out.size());
+	}
+	void load(std::span<const std::byte> in) noexcept
+	{
+		assert(in.size() == getByteSize());
+		std::memcpy(nodes.data(), in.data(), in.size());
+	}
+
+private:
+	DynArray<MapNode, 2> nodes; // [y][x]
+};
+
+// Structure of arrays, a plane of elements and a plane of indices.
+// Scans of elements touch a quarter of the bytes of PackedCells.
+class CellPlanes
+{
+public:
+	explicit CellPlanes(const DynArray<MapNode, 2>& map)
+		: types(map.size(0), map.size(1)), indices(map.size(0), map.size(1))
+	{
+		for (size_t i = 0; i < map.total_size(); i++)
+		{
+			types.data()[i] = map.data()[i].type;
+			indices.data()[i] = map.data()[i].snake_index;
+		}
+	}
+
+public:
+	size_t height() const noexcept
+	{
+		return types.size(0);
+	}
+	size_t width() const noexcept
+	{
+		return types.size(1);
+	}
+	Element getType(size_t x, size_t y) const noexcept
+	{
+		return types[y][x];
+	}
+	int16_t getIndex(size_t x, size_t y) const noexcept
+	{
+		return indices[y][x];
+	}
+	void setType(size_t x, size_t y, Element type) noexcept
+	{
+		types[y][x] = type;
+	}
+	void setIndex(size_t x, size_t y, int16_t index) noexcept
+	{
+		indices[y][x] = index;
+	}
+	const DynArray<Element, 2>& getTypes() const noexcept
+	{
+		return types;
+	}
+
+	size_t getByteSize() const noexcept
+	{
+		return types.total_size() * (sizeof(Element) + sizeof(int16_t));
+	}
+	void save(std::span<std::byte> out) const noexcept
+	{
+		assert(out.size() == getByteSize());
+		size_t type_bytes = types.total_size() * sizeof(Element);
+		std::memcpy(out.data(), types.data(), type_bytes);
+		std::memcpy(out.data() + type_bytes, indices.data(), out.size() - type_bytes);
+	}
+	void load(std::span<const std::byte> in) noexcept
+	{
+		assert(in.size() == getByteSize());
+		size_t type_bytes = types.total_size() * sizeof(Element);
+		std::memcpy(types.data(), in.data(), type_bytes);
+		std::memcpy(indices.data(), in.data() + type_bytes, in.size() - type_bytes);
+	}
+
+private:
+	DynArray<Element, 2> types;    // [y][x]
+	DynArray<int16_t, 2> indices; // [y][x]
+};
+
+// next and previous nodes on a ring of Size nodes, as the snake wraps around
+template<size_t Size>
+struct WrapTable
+{
+	static_assert(Size > 0 && Size <= UINT8_MAX + 1);
+	static constexpr std::array<uint8_t, Size> Next = []
+		{
+			std::array<uint8_t, Size> table{};
+			for (size_t i = 0; i < Size; i++)
+				table[i] = static_cast<uint8_t>(i + 1 == Size ? 0 : i + 1);
+			return table;
+		}();
+	static constexpr std::array<uint8_t, Size> Previous = []
+		{
+			std::array<uint8_t, Size> table{};
+			for (size_t i = 0; i < Size; i++)
+				table[i] = static_cast<uint8_t>(i == 0 ? Size - 1 : i - 1);
+			return table;
+		}();
+};
+
+// Array of MapNode with the dimensions fixed at compile time, for the preset map sizes.
+// The venue steps through the wrap tables instead of comparing with the borders.
+template<size_t Height, size_t Width>
+class FixedCells
+{
+public:
+	using RowWrap = WrapTable<Height>;
+	using ColumnWrap = WrapTable<Width>;
+
+	explicit FixedCells(const DynArray<MapNode, 2>& map)
+	{
+		if (map.size(0) != Height || map.size(1) != Width)
+			throw RuntimeException(L"Invalid Map.");
+		std::copy_n(map.data(), nodes.size(), nodes.begin());
+	}
+
+public:
+	static constexpr size_t height() noexcept
+	{
+		return Height;
+	}
+	static constexpr size_t width() noexcept
+	{
+		return Width;
+	}
+	Element getType(size_t x, size_t y) const noexcept
+	{
+		return nodes[y * Width + x].type;
+	}
+	int16_t getIndex(size_t x, size_t y) const noexcept
+	{
+		return nodes[y * Width + x].snake_index;
+	}
+	void setType(size_t x, size_t y, Element type) noexcept
+	{
+		nodes[y * Width + x].type = type;
+	}
+	void setIndex(size_t x, size_t y, int16_t index) noexcept
+	{
+		nodes[y * Width + x].snake_index = index;
+	}
+
+	static constexpr size_t getByteSize() noexcept
+	{
+		return Height * Width * sizeof(MapNode);
+	}
+	void save(std::span<std::byte> out) const noexcept
+	{
+		assert(out.size() == getByteSize());
+		std::memcpy(out.data(), nodes.data(), getByteSize());
+	}
+	void load(std::span<const std::byte> in) noexcept
+	{
+		assert(in.size() == getByteSize());
+		std::memcpy(nodes.data(), in.data(), getByteSize());
+	}
+
+private:
+	std::array<MapNode, Height * Width> nodes; // [y * Width + x]
+};
+
+static_assert(CellStorage<PackedCells> && CellStorage<CellPlanes> && CellStorage<FixedCells<15, 15>>);
+
+#endif // SNAKE_CELLSTORAGE_HEADER_
\ No newline at end of file
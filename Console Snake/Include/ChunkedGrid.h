@@ -0,0 +1,86 @@
+﻿#pragma once
+#ifndef SNAKE_CHUNKEDGRID_HEADER_
+#define SNAKE_CHUNKEDGRID_HEADER_
+
+#include <vector>
+#include <memory>
+#include <concepts>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+// Grid of (2^ChunkBits)^2 tiles allocated on the first write that changes them.
+// Untouched tiles read as the fill value, so memory follows the area written.
+template<std::equality_comparable T, size_t ChunkBits = 6>
+class ChunkedGrid
+{
+public:
+	static constexpr size_t ChunkSide = size_t{ 1 } << ChunkBits;
+	static constexpr size_t ChunkSize = ChunkSide * ChunkSide;
+
+	ChunkedGrid(size_t height, size_t width, T fill = T{})
+		: grid_height(height), grid_width(width),
+		chunk_columns((width + ChunkSide - 1) >> ChunkBits),
+		chunks(((height + ChunkSide - 1) >> ChunkBits) * chunk_columns),
+		fill(std::move(fill))
+	{}
+
+	const T& get(size_t x, size_t y) const noexcept
+	{
+		assert(x < grid_width && y < grid_height);
+		auto& chunk = chunks[chunkOf(x, y)];
+		return chunk ? chunk[offsetOf(x, y)] : fill;
+	}
+	void set(size_t x, size_t y, const T& value)
+	{
+		assert(x < grid_width && y < grid_height);
+		auto& chunk = chunks[chunkOf(x, y)];
+		if (!chunk)
+		{
+			if (value == fill)
+				return;
+			chunk = std::make_unique<T[]>(ChunkSize);
+			std::fill_n(chunk.get(), ChunkSize, fill);
+			allocated_count++;
+		}
+		chunk[offsetOf(x, y)] = value;
+	}
+
+	size_t height() const noexcept
+	{
+		return grid_height;
+	}
+	size_t width() const noexcept
+	{
+		return grid_width;
+	}
+	size_t getChunkCount() const noexcept
+	{
+		return allocated_count;
+	}
+	// bytes of the allocated tiles and the tile table
+	size_t getMemoryUsage() const noexcept
+	{
+		return allocated_count * ChunkSize * sizeof(T) + chunks.size() * sizeof(chunks[0]);
+	}
+
+private:
+	size_t chunkOf(size_t x, size_t y) const noexcept
+	{
+		return (y >> ChunkBits) * chunk_columns + (x >> ChunkBits);
+	}
+	static size_t offsetOf(size_t x, size_t y) noexcept
+	{
+		return ((y & (ChunkSide - 1)) << ChunkBits) | (x & (ChunkSide - 1));
+	}
+
+private:
+	size_t grid_height;
+	size_t grid_width;
+	size_t chunk_columns;
+	std::vector<std::unique_ptr<T[]>> chunks; // [chunk_y * chunk_columns + chunk_x]
+	size_t allocated_count = 0;
+	T fill;
+};
+
+#endif // SNAKE_CHUNKEDGRID_HEADER_
\ No newline at end of file
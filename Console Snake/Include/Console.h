@@ -5,7 +5,9 @@
 #include "Modules.h"
 #include "WinHeader.h"
 #include "Property.h"
+#include "Terminal.h"
 #include <string>
+#include <memory>
 
 class ConsoleBase
 {
@@ -37,6 +39,7 @@ public:
 	void setConsoleWindow(HasFrame hasframe);
 	void setCursorVisible(bool isVisible);
 	void moveToScreenCenter() noexcept;
+	Terminal& getTerminal() noexcept;
 
 private:
 	void setWindowAttribute(LONG_PTR args);
@@ -45,14 +48,18 @@ private:
 	LONG_PTR getWindowAttribute() const;
 	HANDLE fetchOutputHandle() const;
 	HWND fetchConsoleHandle() const;
+	bool enableVirtualTerminal() const noexcept;
 
 public:
 	UsingProperty(ConsoleBase);
 	Property<HWND, Get> console_handle;
 	Property<HANDLE, Get> output_handle;
+	// whether output handles VT escape sequences, not for the old console host
+	Property<bool, Get> virtual_terminal;
 
 private:
 	std::wstring title;
+	std::unique_ptr<Terminal> terminal;
 };
 
 using Console = ModuleRegister<ConsoleBase>;
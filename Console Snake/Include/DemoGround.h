@@ -5,11 +5,15 @@
 #include "Interface.h"
 #include "Canvas.h"
 #include "Arena.h"
+#include "HamiltonSolver.h"
+#include <memory>
+#include <chrono>
 
 class DemoGround :NotCopyable
 {
+	static constexpr std::chrono::milliseconds FrameInterval{ 90 };
 public:
-	DemoGround(Canvas& canvas);
+	DemoGround(Canvas& canvas, std::unique_ptr<Solver> solver = std::make_unique<HamiltonSolver>());
 
 public:
 	void show();
@@ -20,8 +24,7 @@ private:
 private:
 	Canvas& canvas;
 	Arena arena;
-
-	const DynArray<MapNode, 2>& map;
+	std::unique_ptr<Solver> solver;
 };
 
 #endif // SNAKE_DEMOGROUND_HEADER_
\ No newline at end of file
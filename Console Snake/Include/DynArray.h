@@ -381,8 +381,7 @@ public:
 #endif
 	}
 
-	template<>
-	DynArray()
+	DynArray() noexcept
 		: dim_info{}, total_count(0), arr_data(nullptr)
 	{}
 
@@ -420,7 +419,8 @@ public:
 		this->arr_data = other.arr_data;
 		other.arr_data = nullptr;
 #ifndef NDEBUG
-		other.~DynArray();
+		other.total_count = 0;
+		other.dim_info = {};
 #endif
 	}
 
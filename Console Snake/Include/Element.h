@@ -0,0 +1,18 @@
+﻿#pragma once
+#ifndef SNAKE_ELEMENT_HEADER_
+#define SNAKE_ELEMENT_HEADER_
+
+#include <cstdint>
+
+// one byte, so that map nodes stay small
+enum struct Element :uint8_t
+{
+	Blank = 0,
+	Food,
+	Snake,
+	Barrier,
+
+	Mask_
+};
+
+#endif // SNAKE_ELEMENT_HEADER_
\ No newline at end of file
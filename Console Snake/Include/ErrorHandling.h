@@ -2,6 +2,7 @@
 #ifndef SNAKE_ERRORHANDLING_HEADER_
 #define SNAKE_ERRORHANDLING_HEADER_
 
+#include "Exception.h"
 #include "WideIO.h"
 #include "LocalizedStrings.h"
 #include <string_view>
@@ -10,31 +11,6 @@
 #include <string>
 #include "WinHeader.h"
 
-// Base type of all exceptions
-class Exception
-{
-public:
-	virtual ~Exception() = default;
-
-	[[nodiscard]] virtual const wchar_t* what() const noexcept = 0;
-};
-
-class RuntimeException :public Exception
-{
-public:
-	explicit RuntimeException(std::wstring message) noexcept
-		:buffer(std::move(message))
-	{}
-
-	[[nodiscard]] const wchar_t* what() const noexcept override
-	{
-		return buffer.c_str();
-	}
-
-private:
-	std::wstring buffer;
-};
-
 // handle GetLastError result and convert to readable message to throw
 class NativeException :public Exception
 {
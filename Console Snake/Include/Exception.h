@@ -0,0 +1,33 @@
+﻿#pragma once
+#ifndef SNAKE_EXCEPTION_HEADER_
+#define SNAKE_EXCEPTION_HEADER_
+
+#include <string>
+#include <utility>
+
+// Base type of all exceptions
+class Exception
+{
+public:
+	virtual ~Exception() = default;
+
+	[[nodiscard]] virtual const wchar_t* what() const noexcept = 0;
+};
+
+class RuntimeException :public Exception
+{
+public:
+	explicit RuntimeException(std::wstring message) noexcept
+		:buffer(std::move(message))
+	{}
+
+	[[nodiscard]] const wchar_t* what() const noexcept override
+	{
+		return buffer.c_str();
+	}
+
+private:
+	std::wstring buffer;
+};
+
+#endif // SNAKE_EXCEPTION_HEADER_
\ No newline at end of file
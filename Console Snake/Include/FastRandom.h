@@ -0,0 +1,84 @@
+﻿#pragma once
+#ifndef SNAKE_FASTRANDOM_HEADER_
+#define SNAKE_FASTRANDOM_HEADER_
+
+#include <limits>
+#include <cstdint>
+#include <cassert>
+
+// xoshiro256** (Blackman & Vigna), a small and fast engine for one owner.
+// Satisfies UniformRandomBitGenerator, so std distributions accept it too.
+class FastRandom
+{
+public:
+	using result_type = uint64_t;
+
+public:
+	explicit FastRandom(uint64_t seed) noexcept
+	{
+		reseed(seed);
+	}
+
+public:
+	static constexpr result_type min() noexcept { return 0; }
+	static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+	void reseed(uint64_t seed) noexcept
+	{
+		// expand the seed with splitmix64, never all zero
+		for (auto& word : state)
+		{
+			uint64_t z = (seed += 0x9E3779B97F4A7C15);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+			word = z ^ (z >> 31);
+		}
+	}
+
+	result_type operator()() noexcept
+	{
+		uint64_t result = RotateLeft(state[1] * 5, 7) * 9;
+		uint64_t t = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = RotateLeft(state[3], 45);
+		return result;
+	}
+
+	// random interval: [0, bound), by multiplication instead of modulo (Lemire),
+	// the division only happens on the rare rejection path
+	uint32_t bounded(uint32_t bound) noexcept
+	{
+		assert(bound != 0);
+		uint64_t product = static_cast<uint64_t>((*this)() >> 32) * bound;
+		if (static_cast<uint32_t>(product) < bound)
+		{
+			uint32_t threshold = (0u - bound) % bound;
+			while (static_cast<uint32_t>(product) < threshold)
+				product = static_cast<uint64_t>((*this)() >> 32) * bound;
+		}
+		return static_cast<uint32_t>(product >> 32);
+	}
+
+	// random interval: [min,max]
+	template<typename T>
+	T between(T min, T max) noexcept
+	{
+		assert(min <= max);
+		return static_cast<T>(min + bounded(static_cast<uint32_t>(max - min) + 1));
+	}
+
+private:
+	static constexpr uint64_t RotateLeft(uint64_t x, int k) noexcept
+	{
+		return (x << k) | (x >> (64 - k));
+	}
+
+private:
+	uint64_t state[4];
+};
+
+#endif // SNAKE_FASTRANDOM_HEADER_
\ No newline at end of file
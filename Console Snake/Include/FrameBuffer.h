@@ -0,0 +1,115 @@
+﻿#pragma once
+#ifndef SNAKE_FRAMEBUFFER_HEADER_
+#define SNAKE_FRAMEBUFFER_HEADER_
+
+#include "DynArray.h"
+#include "Element.h"
+#include <span>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+struct FrameCell
+{
+	wchar_t glyph = 0; // 0: nothing drawn or shown
+	uint16_t color = 0;
+
+	friend bool operator==(const FrameCell&, const FrameCell&) = default;
+};
+
+// Double buffer of cells. Drawing goes to the back buffer, and present()
+// hands out the spans of rows that differ from the shown front buffer.
+class FrameBuffer
+{
+	// unchanged cells between two changed ones are output again
+	// if it costs less than moving the cursor
+	static constexpr size_t MaxBridgedCells = 3;
+public:
+	FrameBuffer() = default;
+	FrameBuffer(size_t width, size_t height);
+
+public:
+	void draw(size_t x, size_t y, wchar_t glyph, uint16_t color) noexcept;
+	// forget what is shown, e.g. after the screen is cleared
+	void invalidate() noexcept;
+	size_t width() const noexcept;
+	size_t height() const noexcept;
+
+	// Emit: (x, y, cells) for each span to be output, then the back buffer is shown.
+	template<typename Emit>
+	void present(Emit&& emit)
+	{
+		if (back.total_size() == 0)
+			return;
+		for (size_t y = 0; y < height(); y++)
+		{
+			auto back_row = back[y];
+			auto front_row = front[y];
+			for (size_t x = 0; x < width();)
+			{
+				if (!isDirty(back_row[x], front_row[x]))
+				{
+					x++;
+					continue;
+				}
+				size_t begin = x, end = ++x; // [begin, end) ends with a dirty cell
+				for (size_t gap = 0; x < width() && gap <= MaxBridgedCells; x++)
+				{
+					if (back_row[x].glyph == 0)
+						break;
+					if (isDirty(back_row[x], front_row[x]))
+					{
+						end = x + 1;
+						gap = 0;
+					}
+					else
+						gap++;
+				}
+				x = end;
+				emit(begin, y, std::span<const FrameCell>(back_row.data() + begin, end - begin));
+				std::copy(back_row.data() + begin, back_row.data() + end, front_row.data() + begin);
+			}
+		}
+	}
+
+private:
+	static bool isDirty(const FrameCell& back, const FrameCell& front) noexcept
+	{
+		return back.glyph != 0 && back != front;
+	}
+
+private:
+	DynArray<FrameCell, 2> back;  // [y][x]
+	DynArray<FrameCell, 2> front; // [y][x]
+};
+
+// a map node drawn in two columns
+struct ElementAppearance
+{
+	wchar_t glyph;
+	wchar_t second_glyph; // of the right column
+	uint16_t color;
+};
+
+// console attributes as the default theme of the game uses them
+constexpr ElementAppearance ElementCell(Element which) noexcept
+{
+	constexpr ElementAppearance Appearances[] = {
+		{ L' ', L' ', 0x07 }, // Blank
+		{ L'*', L' ', 0x0C }, // Food
+		{ L'o', L' ', 0x0A }, // Snake
+		{ L'#', L'#', 0x08 }, // Barrier
+	};
+	return Appearances[static_cast<size_t>(which) % std::size(Appearances)];
+}
+
+// the node (x, y) takes the columns x * 2 and x * 2 + 1 of row y
+inline void DrawElementCell(FrameBuffer& frame, size_t x, size_t y, Element which) noexcept
+{
+	auto cell = ElementCell(which);
+	frame.draw(x * 2, y, cell.glyph, cell.color);
+	frame.draw(x * 2 + 1, y, cell.second_glyph, cell.color);
+}
+
+#endif // SNAKE_FRAMEBUFFER_HEADER_
\ No newline at end of file
@@ -0,0 +1,100 @@
+﻿#pragma once
+#ifndef SNAKE_FRAMEEXPORT_HEADER_
+#define SNAKE_FRAMEEXPORT_HEADER_
+
+#include "Interface.h"
+#include "Venue.h"
+#include "SharedMemory.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Layout of a shared memory segment exported by FrameExporter:
+// this header, then height * width bytes of Element row by row.
+// The fields below the sequence and the nodes are guarded by it as a seqlock:
+// odd while the writer changes them, even and increased by 2 for each frame published.
+struct SharedFrameHeader
+{
+	static constexpr uint32_t Magic = 0x464e4b53; // "SKNF" little endian
+	static constexpr uint32_t Version = 1;
+
+	std::atomic<uint32_t> magic; // set last, when the rest is ready
+	uint32_t version;
+	uint16_t height;
+	uint16_t width;
+	uint32_t nodes_offset; // from the beginning of the header
+	std::atomic<uint64_t> sequence;
+	uint64_t frame; // frames played, 0 before the first one
+	uint64_t score;
+	uint32_t snake_length;
+	uint8_t over;
+	uint8_t win;
+	uint8_t closed; // the last frame, the writer is gone
+};
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+			  "atomics in shared memory must be lock free");
+
+// a frame copied out of the segment by FrameReader
+struct SharedFrame
+{
+	uint64_t frame = 0;
+	uint64_t score = 0;
+	uint32_t snake_length = 0;
+	bool over = false;
+	bool win = false;
+	bool closed = false;
+	std::vector<Element> nodes; // row by row
+};
+
+// Publishes the frames of a venue to any number of FrameReader in other processes.
+// Readers only read the segment, so they never block the writer, and a frame costs
+// the writer the same few stores however many readers there are: the nodes changed by it
+// (see PosNodeGroup), the fields of the header, and the sequence twice.
+class FrameExporter :NotCopyable
+{
+public:
+	// The segment is created (replacing an old one of the name) with the whole map of the venue.
+	FrameExporter(const std::string& name, const Venue& venue);
+	// publishes the end of the stream, readers mapping the segment still see it
+	~FrameExporter() noexcept;
+
+public:
+	// after an update of the venue, and the food generated by it
+	void publish(const Venue& venue, PosNodeGroup frame, size_t score, bool win) noexcept;
+
+private:
+	void beginWrite() noexcept;
+	void endWrite() noexcept;
+	void writeNode(PosNode pos, Element which) noexcept;
+
+private:
+	std::unique_ptr<SharedMemory> memory;
+	SharedFrameHeader* header;
+	Element* nodes;
+};
+
+// Maps the segment of a FrameExporter read-only.
+class FrameReader :NotCopyable
+{
+public:
+	// throws RuntimeException if there's no segment of the name or it's not a frame export
+	explicit FrameReader(const std::string& name);
+
+public:
+	size_t getHeight() const noexcept;
+	size_t getWidth() const noexcept;
+	// changes with each frame published, cheap to poll
+	uint64_t getSequence() const noexcept;
+	// Copy the latest frame, retrying while the writer changes it. Returns its sequence.
+	uint64_t read(SharedFrame& out) const;
+
+private:
+	std::unique_ptr<SharedMemory> memory;
+	const SharedFrameHeader* header;
+	const Element* nodes;
+};
+
+#endif // SNAKE_FRAMEEXPORT_HEADER_
\ No newline at end of file
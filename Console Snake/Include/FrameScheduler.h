@@ -0,0 +1,43 @@
+﻿#pragma once
+#ifndef SNAKE_FRAMESCHEDULER_HEADER_
+#define SNAKE_FRAMESCHEDULER_HEADER_
+
+#include "Interface.h"
+#include <chrono>
+#include <cstddef>
+
+struct FrameStats
+{
+	size_t ticks = 0;
+	size_t late_frames = 0; // woke up a whole step or more after the deadline
+	size_t dropped_frames = 0; // too late to catch up, skipped
+	std::chrono::steady_clock::duration max_overshoot{};
+};
+
+// Fixed-timestep pacing with absolute deadlines on a monotonic clock.
+// The tick count only depends on the time elapsed, not on how long a frame takes.
+class FrameScheduler :NotCopyable
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	static constexpr size_t DefaultMaxCatchUp = 4;
+
+public:
+	explicit FrameScheduler(Clock::duration step, size_t max_catch_up = DefaultMaxCatchUp) noexcept;
+
+public:
+	// the next frame is due right now, used on start and after pausing
+	void restart() noexcept;
+	// block until the next deadline, return the count of ticks due (at least 1)
+	size_t wait();
+	FrameStats getStats() const noexcept;
+	Clock::duration getStep() const noexcept;
+
+private:
+	Clock::duration step;
+	size_t max_catch_up;
+	Clock::time_point deadline;
+	FrameStats stats;
+};
+
+#endif // SNAKE_FRAMESCHEDULER_HEADER_
\ No newline at end of file
@@ -0,0 +1,77 @@
+﻿#pragma once
+#ifndef SNAKE_GAMESESSION_HEADER_
+#define SNAKE_GAMESESSION_HEADER_
+
+#include "Interface.h"
+#include "HeadlessVenue.h"
+#include "FrameBuffer.h"
+#include "AnsiTerminal.h"
+#include <chrono>
+#include <deque>
+#include <span>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// what a session plays, each session has its own copy
+struct SessionSettings
+{
+	DynArray<MapNode, 2> map;
+	int speed = 7; // 1-10, as the game
+};
+
+// One game played by a remote terminal: keys in, ANSI sequences out.
+// It touches no global state of the game (Console, Canvas, GameSetting, GameData),
+// so any number of sessions live in one process, see SessionServer.
+// Not thread-safe: receive() and tick() of a session are never called at the same time.
+//
+// keys: arrows or WASD to turn, space to pause, + and - for the speed,
+//       R to play again after the game is over, Q or Ctrl-C to quit
+class GameSession :NotCopyable
+{
+	static constexpr size_t InputQueueCapacity = 16;
+public:
+	using Clock = std::chrono::steady_clock;
+	enum struct Status
+	{
+		Opening, Running, Pausing, Over, Closing
+	};
+
+public:
+	GameSession(SessionSettings settings, uint64_t seed);
+
+public:
+	// bytes typed by the client
+	void receive(std::span<const char> bytes);
+	// there's a frame due or something to render
+	bool isDue(Clock::time_point now) const noexcept;
+	// step the game if the frame is due, and render unless the output is not sent yet
+	void tick(Clock::time_point now);
+	// rendered and not sent yet, the sender erases what it sent
+	std::string& getOutput() noexcept;
+	Status getStatus() const noexcept;
+	size_t getScore() const noexcept;
+
+private:
+	void onKey(char key);
+	void restart();
+	void render();
+	Direction popLegalInput() noexcept;
+	Clock::duration getFrameInterval() const noexcept;
+
+private:
+	SessionSettings settings;
+	uint64_t seed;
+	HeadlessVenue venue;
+	std::deque<Direction> input_queue;
+	Status status = Status::Opening;
+	Clock::time_point next_frame;
+	int escape_state = 0; // position in ESC [ A
+	bool dirty = true; // the screen differs from what was rendered
+	FrameBuffer frame;
+	std::string output;
+	AnsiTerminal terminal; // after output, flushes into it
+	std::wstring text;
+};
+
+#endif // SNAKE_GAMESESSION_HEADER_
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "Resource.h"
 #include "GlobalResourceWrapper.h"
 #include "PageInterface.h"
+#include <string>
+#include <chrono>
 
 struct GameDataMember
 {
@@ -13,6 +15,13 @@ struct GameDataMember
 	bool exit_game = false;
 	bool retry_game = false;
 	bool colorful_title = false;
+	// command line of a bot process playing instead of the keyboard, see BotSession
+	std::wstring bot_command;
+	std::chrono::milliseconds bot_deadline{}; // 0: one frame
+	// shared memory the frames are published to, see FrameExporter
+	std::string export_name;
+	// file the replay of each game is written to, see Replay, none if empty
+	std::string replay_file;
 };
 using GameData = GlobalResourceWrapper<GameDataMember>;
 
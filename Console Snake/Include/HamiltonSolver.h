@@ -0,0 +1,100 @@
+﻿#pragma once
+#ifndef SNAKE_HAMILTONSOLVER_HEADER_
+#define SNAKE_HAMILTONSOLVER_HEADER_
+
+#include "Interface.h"
+#include "Solver.h"
+#include "Venue.h"
+#include "DynArray.h"
+#include <future>
+#include <mutex>
+#include <optional>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// A cycle through every non-barrier node of a map, moving as the snake does.
+struct HamiltonCycle
+{
+	size_t height = 0;
+	size_t width = 0;
+	std::vector<PosNode> path; // nodes in the order of the cycle
+	std::vector<uint32_t> order; // [y * width + x] -> index in path, NoOrder for barriers
+
+	static constexpr uint32_t NoOrder = UINT32_MAX;
+	uint32_t orderOf(PosNode pos) const noexcept { return order[pos.y * width + pos.x]; }
+	// steps along the cycle from one node to another
+	size_t distance(uint32_t from, uint32_t to) const noexcept
+	{
+		return to >= from ? to - from : to + path.size() - from;
+	}
+};
+
+// Identifies the barriers of a map, snake and food are ignored.
+uint64_t HashMapShape(const DynArray<MapNode, 2>& map) noexcept;
+// Build the cycle for rectangular free areas, otherwise search with at most search_budget steps.
+// Empty if there is no cycle (e.g. odd-sized bounded areas) or the search gives up.
+std::optional<HamiltonCycle> FindHamiltonCycle(const DynArray<MapNode, 2>& map, size_t search_budget);
+
+// Cycles by map shape, computed once in the background, kept in memory and
+// optionally in files named SnakeCycle-<hash>.bin under a directory.
+class CycleCache :NotCopyable
+{
+public:
+	using CycleFuture = std::shared_future<std::optional<HamiltonCycle>>;
+	static constexpr size_t SearchBudget = 2'000'000;
+
+public:
+	explicit CycleCache(std::optional<std::filesystem::path> directory);
+	// the cache of the game, in the working directory
+	static CycleCache& Shared();
+
+public:
+	CycleFuture request(const DynArray<MapNode, 2>& map);
+
+private:
+	std::optional<HamiltonCycle> loadOrFind(const DynArray<MapNode, 2>& map, uint64_t hash) const;
+	std::filesystem::path pathOf(uint64_t hash) const;
+
+private:
+	std::optional<std::filesystem::path> directory;
+	std::mutex mutex;
+	std::unordered_map<uint64_t, CycleFuture> cycles;
+};
+
+// Follow the Hamilton cycle of the map, taking shortcuts towards the food
+// while the snake is short. Plays with the fallback solver while the cycle is
+// being found, and for good if there is none (e.g. the odd-sized 15 Square).
+// Wins are not guaranteed: the fallback may trap the snake before it can join
+// the cycle (about 1-2% of the games on the 16 Square).
+class HamiltonSolver :public Solver
+{
+public:
+	explicit HamiltonSolver(CycleCache& cache = CycleCache::Shared());
+
+public:
+	Direction solveNextStep(const Venue& venue) override;
+	std::wstring_view name() const noexcept override;
+
+private:
+	// Whether following the cycle from now on is safe: at once if the body lies along
+	// the cycle in order from the tail to the head, otherwise by simulating a lap,
+	// which copies the venue, so only once in LapCheckInterval calls.
+	bool canJoinCycle(const Venue& venue);
+	Direction followCycle(const Venue& venue);
+
+private:
+	CycleCache& cache;
+	CycleCache::CycleFuture cycle_future;
+	const HamiltonCycle* cycle = nullptr;
+	bool on_cycle = false;
+	size_t steps_on_cycle = 0;
+	std::optional<PosNode> last_head;
+	size_t steps_in_order = 0; // moves in a row to the next node of the cycle
+	size_t calls_since_lap = 0;
+	GreedySolver fallback;
+};
+
+#endif // SNAKE_HAMILTONSOLVER_HEADER_
\ No newline at end of file
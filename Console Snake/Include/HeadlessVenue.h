@@ -0,0 +1,85 @@
+﻿#pragma once
+#ifndef SNAKE_HEADLESSVENUE_HEADER_
+#define SNAKE_HEADLESSVENUE_HEADER_
+
+#include "Venue.h"
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+// Venue driven without console, settings or sounds, for simulations and replays.
+template<CellStorage Storage>
+class BasicHeadlessVenue :public BasicVenue<Storage>
+{
+	using Base = BasicVenue<Storage>;
+public:
+	explicit BasicHeadlessVenue(DynArray<MapNode, 2> map);
+	BasicHeadlessVenue(DynArray<MapNode, 2> map, uint64_t seed);
+
+public:
+	PosNodeGroup step(Direction input = Direction::None);
+	// step until the inputs are consumed or the game is over,
+	// return the count of inputs consumed
+	size_t stepN(std::span<const Direction> inputs);
+
+	bool isOver() const noexcept;
+	bool isWin() const noexcept;
+	size_t getScore() const noexcept;
+	size_t getTicks() const noexcept;
+
+	// Venue's snapshot followed by the score and ticks
+	size_t getSnapshotSize() const noexcept;
+	void snapshot(std::span<std::byte> buffer) const noexcept;
+	void restore(std::span<const std::byte> buffer) noexcept;
+
+private:
+	struct Progress
+	{
+		size_t score;
+		size_t ticks;
+		bool game_over;
+	};
+
+private:
+	size_t score = 0;
+	size_t ticks = 0;
+	bool game_over = false;
+};
+
+extern template class BasicHeadlessVenue<PackedCells>;
+extern template class BasicHeadlessVenue<CellPlanes>;
+extern template class BasicHeadlessVenue<FixedCells<15, 15>>;
+extern template class BasicHeadlessVenue<FixedCells<20, 20>>;
+extern template class BasicHeadlessVenue<FixedCells<24, 24>>;
+using HeadlessVenue = BasicHeadlessVenue<PackedCells>;
+template<size_t Size>
+using FixedHeadlessVenue = BasicHeadlessVenue<FixedCells<Size, Size>>;
+
+// Call visitor(venue) with a FixedHeadlessVenue if the map is square of a preset size,
+// otherwise with a HeadlessVenue. The visitor returns the same type for all of them.
+template<typename Visitor>
+decltype(auto) VisitHeadlessVenue(DynArray<MapNode, 2> map, uint64_t seed, Visitor&& visitor)
+{
+	auto visit = [&]<typename VenueType>(std::type_identity<VenueType>) -> decltype(auto)
+		{
+			VenueType venue(std::move(map), seed);
+			return visitor(venue);
+		};
+	if (map.size(0) == map.size(1))
+	{
+		switch (map.size(0))
+		{
+			case 15:
+				return visit(std::type_identity<FixedHeadlessVenue<15>>{});
+			case 20:
+				return visit(std::type_identity<FixedHeadlessVenue<20>>{});
+			case 24:
+				return visit(std::type_identity<FixedHeadlessVenue<24>>{});
+		}
+	}
+	return visit(std::type_identity<HeadlessVenue>{});
+}
+
+#endif // SNAKE_HEADLESSVENUE_HEADER_
\ No newline at end of file
@@ -0,0 +1,237 @@
+﻿#pragma once
+#ifndef SNAKE_LARGEVENUE_HEADER_
+#define SNAKE_LARGEVENUE_HEADER_
+
+#include "Venue.h"
+#include "ChunkedGrid.h"
+#include "FastRandom.h"
+#include "Exception.h"
+#include <deque>
+#include <span>
+#include <optional>
+#include <limits>
+#include <concepts>
+#include <cstdint>
+#include <cstddef>
+
+// Single-snake game as HeadlessVenue plays it, on maps too large for Venue.
+// Coordinates are Coord wide, nodes are kept in lazily allocated tiles,
+// so memory follows the barriers and the area the snake has visited.
+template<std::unsigned_integral Coord>
+class BasicLargeVenue
+{
+	static constexpr size_t SnakeInitLength = 3;
+	// random tries of food placement before scanning the map
+	static constexpr size_t FoodTries = 64;
+public:
+	using Position = BasicPosNode<Coord>;
+	using PositionGroup = BasicPosNodeGroup<Coord>;
+
+	struct Rect
+	{
+		size_t x;
+		size_t y;
+		size_t width;
+		size_t height;
+	};
+
+public:
+	// the snake starts at the center heading right
+	BasicLargeVenue(size_t height, size_t width, std::span<const Rect> barriers, uint64_t seed)
+		: nodes(height, width, Element::Blank), random_engine(seed)
+	{
+		if (height < 2 || width < SnakeInitLength + 1 ||
+			height - 1 > std::numeric_limits<Coord>::max() || width - 1 > std::numeric_limits<Coord>::max())
+			throw RuntimeException(L"Invalid Map.");
+		blank_count = height * width;
+		for (auto& rect : barriers)
+		{
+			for (size_t y = rect.y; y < rect.y + rect.height && y < height; y++)
+				for (size_t x = rect.x; x < rect.x + rect.width && x < width; x++)
+					if (setType({ static_cast<Coord>(x), static_cast<Coord>(y) }, Element::Barrier) == Element::Blank)
+						blank_count--;
+		}
+
+		Position pos{ static_cast<Coord>(width / 2 - SnakeInitLength / 2), static_cast<Coord>(height / 2) };
+		for (size_t i = 0; i < SnakeInitLength; i++, pos.x++)
+		{
+			if (getPositionType(pos) != Element::Blank)
+				throw RuntimeException(L"Invalid Map.");
+			setType(pos, Element::Snake);
+			body.push_front(pos);
+			blank_count--;
+		}
+		generateFood();
+	}
+
+public:
+	// the same rules as HeadlessVenue::step()
+	PositionGroup step(Direction input = Direction::None)
+	{
+		assert(!game_over);
+		if (input != Direction::None && !input.isConflictWith(direct))
+			direct = input;
+		ticks++;
+
+		auto head = getAdjacentPosition(body.front(), direct);
+		auto previous_type = getPositionType(head);
+		if (previous_type == Element::Barrier || previous_type == Element::Snake)
+		{
+			game_over = true;
+			return { 0, {}, {} };
+		}
+		setType(head, Element::Snake);
+		body.push_front(head);
+		if (previous_type == Element::Food)
+		{
+			food.reset();
+			score++;
+			generateFood();
+			return { 1, head, {} };
+		}
+		blank_count--;
+
+		auto tail = body.back();
+		body.pop_back();
+		setType(tail, Element::Blank);
+		blank_count++;
+		return { 2, head, tail };
+	}
+
+	Position getAdjacentPosition(Position pos, Direction to) const noexcept
+	{
+		const Coord height_max = static_cast<Coord>(nodes.height() - 1);
+		const Coord width_max = static_cast<Coord>(nodes.width() - 1);
+		switch (+to)
+		{
+			case Direction::Up:
+				pos.y == 0 ? pos.y = height_max : pos.y--;
+				break;
+			case Direction::Down:
+				pos.y == height_max ? pos.y = 0 : pos.y++;
+				break;
+			case Direction::Left:
+				pos.x == 0 ? pos.x = width_max : pos.x--;
+				break;
+			case Direction::Right:
+				pos.x == width_max ? pos.x = 0 : pos.x++;
+				break;
+			default:
+				break;
+		}
+		return pos;
+	}
+	Element getPositionType(Position pos) const noexcept
+	{
+		return nodes.get(pos.x, pos.y);
+	}
+
+	Position getSnakeHead() const noexcept
+	{
+		return body.front();
+	}
+	Position getSnakeTail() const noexcept
+	{
+		return body.back();
+	}
+	Direction getSnakeDirection() const noexcept
+	{
+		return direct;
+	}
+	size_t getSnakeLength() const noexcept
+	{
+		return body.size();
+	}
+	std::optional<Position> getFoodPosition() const noexcept
+	{
+		return food;
+	}
+	size_t getHeight() const noexcept
+	{
+		return nodes.height();
+	}
+	size_t getWidth() const noexcept
+	{
+		return nodes.width();
+	}
+	bool isOver() const noexcept
+	{
+		return game_over;
+	}
+	bool isWin() const noexcept
+	{
+		return blank_count == 0 && !food;
+	}
+	size_t getScore() const noexcept
+	{
+		return score;
+	}
+	size_t getTicks() const noexcept
+	{
+		return ticks;
+	}
+	// tiles allocated, and their bytes with the body
+	size_t getChunkCount() const noexcept
+	{
+		return nodes.getChunkCount();
+	}
+	size_t getMemoryUsage() const noexcept
+	{
+		return nodes.getMemoryUsage() + body.size() * sizeof(Position);
+	}
+
+private:
+	// return the previous type
+	Element setType(Position pos, Element type)
+	{
+		auto previous = getPositionType(pos);
+		nodes.set(pos.x, pos.y, type);
+		return previous;
+	}
+
+	void generateFood()
+	{
+		if (blank_count == 0)
+			return;
+		auto random_position = [this]
+			{
+				return Position{
+					static_cast<Coord>(random_engine.between<size_t>(0, getWidth() - 1)),
+					static_cast<Coord>(random_engine.between<size_t>(0, getHeight() - 1)),
+				};
+			};
+		Position pos = random_position();
+		for (size_t i = 1; i < FoodTries && getPositionType(pos) != Element::Blank; i++)
+			pos = random_position();
+		// crowded, walk on from the last try
+		while (getPositionType(pos) != Element::Blank)
+		{
+			if (pos.x + size_t{ 1 } < getWidth())
+				pos.x++;
+			else
+			{
+				pos.x = 0;
+				pos.y = static_cast<Coord>(pos.y + size_t{ 1 } == getHeight() ? 0 : pos.y + 1);
+			}
+		}
+		setType(pos, Element::Food);
+		food = pos;
+		blank_count--;
+	}
+
+private:
+	ChunkedGrid<Element> nodes; // [y][x]
+	std::deque<Position> body; // from the head to the tail
+	Direction direct = Direction::Right;
+	std::optional<Position> food;
+	size_t blank_count = 0;
+	size_t score = 0;
+	size_t ticks = 0;
+	bool game_over = false;
+	FastRandom random_engine;
+};
+
+// maps up to 65536x65536
+using LargeVenue = BasicLargeVenue<uint16_t>;
+
+#endif // SNAKE_LARGEVENUE_HEADER_
\ No newline at end of file
@@ -0,0 +1,113 @@
+﻿#pragma once
+#ifndef SNAKE_MULTISNAKEVENUE_HEADER_
+#define SNAKE_MULTISNAKEVENUE_HEADER_
+
+#include "Interface.h"
+#include "Venue.h"
+#include "FastRandom.h"
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+// Many snakes on one map, all of them move in one tick.
+// Snake bodies are linked through the cells, so a tick costs O(1) per snake
+// besides dying ones, and never allocates.
+//
+// Rules of a tick, which don't depend on the order of snakes:
+// - A snake dies if it moves into a barrier or a snake body. The tail of a snake
+//   which isn't growing is left in the same tick, so it could be followed.
+// - Snakes moving into the same node: the longest survives, all die on a tie.
+//   So is food contention decided.
+// - Heads moving into each other (snakes of one node, whose heads are tails)
+//   collide head-on, both die instead of passing through each other.
+// - Eating makes the snake one node longer, by keeping its tail in the next tick.
+// - Bodies of dead snakes are cleared, and food is refilled to the given count.
+class MultiSnakeVenue :NotCopyable
+{
+public:
+	static constexpr uint32_t NoSnake = UINT32_MAX;
+
+	struct Cell
+	{
+		Element type = Element::Blank;
+		uint32_t owner = NoSnake;
+		Direction toward_head; // of snake nodes except heads
+	};
+
+	struct Snake
+	{
+		PosNode head;
+		PosNode tail;
+		Direction direct;
+		Direction ordered;
+		uint32_t length = 0;
+		uint32_t growth = 0; // ticks to keep the tail
+		size_t score = 0;
+		bool alive = false;
+	};
+
+	struct TickResult
+	{
+		size_t deaths;
+		size_t meals;
+	};
+
+public:
+	// barriers of the map are kept, other nodes start blank
+	MultiSnakeVenue(const DynArray<MapNode, 2>& map, size_t food_count, uint64_t seed);
+
+public:
+	// Place a straight snake on random blank nodes, reusing ids of dead snakes.
+	// Empty if no room was found in a few tries.
+	std::optional<uint32_t> spawnSnake(size_t length);
+	// ignored if backwards, kept until changed
+	void orderDirection(uint32_t snake, Direction direct) noexcept;
+	TickResult tick();
+
+	PosNode getAdjacentPosition(PosNode pos, Direction direct) const noexcept;
+	const Cell& getCell(PosNode pos) const noexcept;
+	const Snake& getSnake(uint32_t snake) const noexcept;
+	// count of slots, including dead snakes
+	size_t getSnakeCount() const noexcept;
+	size_t getAliveCount() const noexcept;
+	size_t getFoodCount() const noexcept;
+	size_t getTicks() const noexcept;
+	size_t getHeight() const noexcept;
+	size_t getWidth() const noexcept;
+
+private:
+	// claim of the next head position, the longest claimant wins
+	struct Claim
+	{
+		size_t tick = 0;
+		uint32_t length = 0;
+		uint32_t winner = NoSnake; // NoSnake if tied
+	};
+
+	Cell& cellAt(PosNode pos) noexcept;
+	std::optional<PosNode> findBlank();
+	void refillFood();
+	void removeBody(const Snake& snake) noexcept;
+	bool isLeftThisTick(PosNode pos) const noexcept;
+	// whether the snake moves into a head which moves into its head, only after targets are set
+	bool isSwappingHeads(size_t id) const noexcept;
+
+private:
+	DynArray<Cell, 2> cells; // cells[y][x]
+	std::vector<Snake> snakes;
+	std::vector<uint32_t> free_ids; // slots of dead snakes
+	size_t alive_count = 0;
+	size_t blank_count = 0;
+	size_t food_count = 0;
+	size_t food_target;
+	size_t ticks = 0;
+	FastRandom random_engine;
+
+	// scratch of tick(), [snake]
+	std::vector<PosNode> targets;
+	std::vector<bool> dying;
+	DynArray<Claim, 2> claims;
+};
+
+#endif // SNAKE_MULTISNAKEVENUE_HEADER_
\ No newline at end of file
@@ -0,0 +1,162 @@
+﻿#pragma once
+#ifndef SNAKE_OBSERVATIONENCODER_HEADER_
+#define SNAKE_OBSERVATIONENCODER_HEADER_
+
+#include "Venue.h"
+#include <optional>
+#include <span>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+enum struct ObservationLayout :uint8_t
+{
+	// ObservationEncoder::PlaneCount planes of height * width bytes, 0 or 1, in the order of ObservationPlane
+	Planes,
+	// height * width int8_t, one ObservationCode each
+	Grid,
+};
+
+enum struct ObservationPlane :uint8_t
+{
+	Barrier,
+	Body, // all snake nodes, the head and tail included
+	Head,
+	Food,
+	Tail,
+};
+
+enum struct ObservationCode :int8_t
+{
+	Blank,
+	Barrier,
+	Body,
+	Head,
+	Food,
+	Tail, // the head wins if the snake is one node long
+};
+
+// Writes the board of a venue as an observation for learning agents into a buffer of the caller,
+// e.g. memory of a tensor, so nothing is copied afterwards. After encode(), update() keeps it
+// up to date with the nodes changed by a frame only, as reported by the PosNodeGroup of it.
+// Works with any BasicVenue, HeadlessVenue and Arena.
+class ObservationEncoder
+{
+public:
+	static constexpr size_t PlaneCount = 5;
+
+public:
+	ObservationEncoder(ObservationLayout layout, size_t height, size_t width) noexcept
+		: layout(layout), height(height), width(width)
+	{
+
+	}
+
+public:
+	static size_t GetByteSize(ObservationLayout layout, size_t height, size_t width) noexcept
+	{
+		return (layout == ObservationLayout::Planes ? PlaneCount : 1) * height * width;
+	}
+
+	size_t getByteSize() const noexcept
+	{
+		return GetByteSize(layout, height, width);
+	}
+
+	// write the whole board
+	template<typename VenueType>
+	void encode(const VenueType& venue, std::span<std::byte> buffer) noexcept
+	{
+		assert(buffer.size() >= getByteSize());
+		assert(venue.getHeight() == height && venue.getWidth() == width);
+		head = venue.getSnakeHead();
+		tail = venue.getSnakeTail();
+		food = venue.getFoodPosition();
+		for (size_t y = 0; y < height; y++)
+			for (size_t x = 0; x < width; x++)
+				writeNode(venue, buffer, { static_cast<uint8_t>(x), static_cast<uint8_t>(y) });
+	}
+
+	// Rewrite the nodes changed by the frame (count 0 changes nothing), after the frame
+	// and the food generated by it. The buffer must be the one of the last encode().
+	template<typename VenueType>
+	void update(const VenueType& venue, PosNodeGroup frame, std::span<std::byte> buffer) noexcept
+	{
+		assert(buffer.size() >= getByteSize());
+		if (frame.count == 0)
+			return;
+		assert(frame.head_pos == venue.getSnakeHead());
+		assert(frame.count == 1 || frame.tail_pos == tail);
+		PosNode old_head = head, old_tail = tail;
+		std::optional<PosNode> old_food = food;
+		head = frame.head_pos;
+		tail = venue.getSnakeTail();
+		food = venue.getFoodPosition();
+
+		writeNode(venue, buffer, old_head);
+		writeNode(venue, buffer, head);
+		if (frame.count == 2)
+		{
+			writeNode(venue, buffer, old_tail);
+			writeNode(venue, buffer, tail);
+		}
+		if (old_food != food)
+		{
+			if (old_food && *old_food != head)
+				writeNode(venue, buffer, *old_food);
+			if (food)
+				writeNode(venue, buffer, *food);
+		}
+	}
+
+private:
+	template<typename VenueType>
+	void writeNode(const VenueType& venue, std::span<std::byte> buffer, PosNode pos) const noexcept
+	{
+		Element type = venue.getPositionType(pos.x, pos.y);
+		bool is_head = type == Element::Snake && pos == head;
+		bool is_tail = type == Element::Snake && pos == tail && !is_head;
+		size_t offset = pos.y * width + pos.x;
+		if (layout == ObservationLayout::Grid)
+		{
+			ObservationCode code = ObservationCode::Blank;
+			switch (type)
+			{
+				case Element::Barrier:
+					code = ObservationCode::Barrier;
+					break;
+				case Element::Food:
+					code = ObservationCode::Food;
+					break;
+				case Element::Snake:
+					code = is_head ? ObservationCode::Head : is_tail ? ObservationCode::Tail : ObservationCode::Body;
+					break;
+				default:
+					break;
+			}
+			buffer[offset] = static_cast<std::byte>(code);
+			return;
+		}
+		auto plane = [&](ObservationPlane plane, bool value)
+			{
+				buffer[static_cast<size_t>(plane) * height * width + offset] = static_cast<std::byte>(value);
+			};
+		plane(ObservationPlane::Barrier, type == Element::Barrier);
+		plane(ObservationPlane::Body, type == Element::Snake);
+		plane(ObservationPlane::Head, is_head);
+		plane(ObservationPlane::Food, type == Element::Food);
+		plane(ObservationPlane::Tail, type == Element::Snake && pos == tail);
+	}
+
+private:
+	ObservationLayout layout;
+	size_t height;
+	size_t width;
+	// as written to the buffer
+	PosNode head{};
+	PosNode tail{};
+	std::optional<PosNode> food;
+};
+
+#endif // SNAKE_OBSERVATIONENCODER_HEADER_
\ No newline at end of file
@@ -0,0 +1,155 @@
+﻿#pragma once
+#ifndef SNAKE_OCCUPANCYBOARD_HEADER_
+#define SNAKE_OCCUPANCYBOARD_HEADER_
+
+#include "Element.h"
+#include "DynArray.h"
+#include <algorithm>
+#include <bit>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+// Bit-packed occupancy of map elements, each row of a plane is packed into
+// one 64-bit word, bit x of rows[plane][y] stands for map[y][x].
+// The Blank plane is implied by the absence of the other planes.
+class OccupancyBoard
+{
+	static constexpr size_t PlaneCount = static_cast<size_t>(Element::Mask_) - 1;
+public:
+	static constexpr size_t MaxWidth = 64;
+
+public:
+	OccupancyBoard(size_t height, size_t width)
+		: rows(PlaneCount, height), board_width(width)
+		, row_mask(width == MaxWidth ? ~uint64_t{ 0 } : (uint64_t{ 1 } << width) - 1)
+	{
+		assert(width != 0 && width <= MaxWidth);
+		std::fill(rows.iter_all().begin(), rows.iter_all().end(), uint64_t{ 0 });
+	}
+
+public:
+	void assign(Element type, size_t x, size_t y) noexcept
+	{
+		const uint64_t bit = uint64_t{ 1 } << x;
+		for (size_t plane = 0; plane < PlaneCount; plane++)
+			rows[plane][y] &= ~bit;
+		if (type != Element::Blank)
+			rows[planeOf(type)][y] |= bit;
+	}
+	Element get(size_t x, size_t y) const noexcept
+	{
+		for (size_t plane = 0; plane < PlaneCount; plane++)
+			if (rows[plane][y] >> x & 1)
+				return static_cast<Element>(plane + 1);
+		return Element::Blank;
+	}
+	bool isBlocked(size_t x, size_t y) const noexcept
+	{
+		return (blockedRow(y) >> x & 1) != 0;
+	}
+	uint64_t row(Element type, size_t y) const noexcept
+	{
+		assert(type != Element::Blank);
+		return rows[planeOf(type)][y];
+	}
+	// Blank and Food nodes
+	uint64_t freeRow(size_t y) const noexcept
+	{
+		return ~blockedRow(y) & row_mask;
+	}
+	// all planes as one array of rows, for snapshots
+	std::span<uint64_t> words() noexcept
+	{
+		return { rows.iter_all().begin(), rows.total_size() };
+	}
+	std::span<const uint64_t> words() const noexcept
+	{
+		return { rows.iter_all().begin(), rows.total_size() };
+	}
+	size_t height() const noexcept
+	{
+		return rows.size(1);
+	}
+	size_t width() const noexcept
+	{
+		return board_width;
+	}
+
+	size_t count(Element type) const noexcept
+	{
+		if (type == Element::Blank)
+			return height() * width() - count(Element::Food) - count(Element::Snake) - count(Element::Barrier);
+		size_t result = 0;
+		for (size_t y = 0; y < height(); y++)
+			result += std::popcount(rows[planeOf(type)][y]);
+		return result;
+	}
+
+	// Count free nodes reachable from (x, y) including itself, moving through
+	// the map borders as the snake does. Returns 0 if (x, y) is not free.
+	// The scratch buffer should hold at least height() words.
+	size_t countReachable(size_t x, size_t y, uint64_t* scratch) const noexcept
+	{
+		if (isBlocked(x, y))
+			return 0;
+		const size_t h = height();
+		uint64_t* reach = scratch;
+		std::fill_n(reach, h, uint64_t{ 0 });
+		reach[y] = uint64_t{ 1 } << x;
+
+		// expand the reachable area in all rows at once until it stops growing
+		for (bool changed = true; changed;)
+		{
+			changed = false;
+			for (size_t row_y = 0; row_y < h; row_y++)
+			{
+				uint64_t up = reach[row_y == 0 ? h - 1 : row_y - 1];
+				uint64_t down = reach[row_y == h - 1 ? 0 : row_y + 1];
+				uint64_t next = (reach[row_y] | up | down) & freeRow(row_y);
+				// flood along the row while staying inside the free runs
+				for (uint64_t prev = 0; prev != next;)
+				{
+					prev = next;
+					next = (next | rotateLeft(next) | rotateRight(next)) & freeRow(row_y);
+				}
+				if (next != reach[row_y])
+				{
+					reach[row_y] = next;
+					changed = true;
+				}
+			}
+		}
+		size_t result = 0;
+		for (size_t row_y = 0; row_y < h; row_y++)
+			result += std::popcount(reach[row_y]);
+		return result;
+	}
+
+private:
+	static constexpr size_t planeOf(Element type) noexcept
+	{
+		return static_cast<size_t>(type) - 1;
+	}
+	uint64_t blockedRow(size_t y) const noexcept
+	{
+		return rows[planeOf(Element::Barrier)][y] | rows[planeOf(Element::Snake)][y];
+	}
+	// rotate inside the board width so that nodes on borders are adjacent
+	uint64_t rotateLeft(uint64_t row) const noexcept
+	{
+		return (row << 1 | row >> (board_width - 1)) & row_mask;
+	}
+	uint64_t rotateRight(uint64_t row) const noexcept
+	{
+		return (row >> 1 | row << (board_width - 1)) & row_mask;
+	}
+
+private:
+	DynArray<uint64_t, 2> rows; // rows[plane][y]
+	size_t board_width;
+	uint64_t row_mask;
+};
+
+#endif // SNAKE_OCCUPANCYBOARD_HEADER_
\ No newline at end of file
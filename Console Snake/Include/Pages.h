@@ -7,6 +7,7 @@
 #include "GlobalData.h"
 #include "Resource.h"
 #include "DynArray.h"
+#include "Timer.h"
 #include <memory>
 #include <optional>
 
@@ -166,7 +167,8 @@ public:
 
 private:
 	void paintInterface();
-	std::shared_ptr<bool> is_press = std::make_shared<bool>(false);
+	void repaintTitle(Color color);
+	std::optional<Timer> title_timer;
 };
 
 class RankPage :public NormalPage
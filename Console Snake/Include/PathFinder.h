@@ -0,0 +1,77 @@
+﻿#pragma once
+#ifndef SNAKE_PATHFINDER_HEADER_
+#define SNAKE_PATHFINDER_HEADER_
+
+#include "Interface.h"
+#include "Venue.h"
+#include <vector>
+#include <array>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+// Shortest paths and reachable areas on the map of a Venue, through the borders.
+// The scratch buffers are sized on the first query of a map size, later queries
+// never allocate. Results refer to the buffers and last until the next query.
+// Only Blank and Food nodes are passable, the source node may be anything.
+class PathFinder :NotCopyable
+{
+public:
+	static constexpr uint32_t Unreachable = UINT32_MAX;
+
+	// where a move of the head leads to
+	struct MoveOutlook
+	{
+		Direction direct;
+		bool legal = false; // neither backwards nor into barrier or snake
+		uint32_t food_distance = Unreachable; // from the node moved to
+		size_t reachable = 0; // count of passable nodes reachable from the node moved to
+	};
+	// in the order of Up, Left, Right, Down
+	using MoveSurvey = std::array<MoveOutlook, 4>;
+
+public:
+	PathFinder() = default;
+	explicit PathFinder(const DynArray<MapNode, 2>& map);
+
+public:
+	// size the buffers for the map, done by the queries if needed
+	void prepare(const DynArray<MapNode, 2>& map);
+
+	// breadth-first distances from the source, read them by getDistance()
+	void measureFrom(const Venue& venue, PosNode source);
+	uint32_t getDistance(PosNode pos) const noexcept;
+
+	// A* from one node to another, empty if unreachable
+	std::span<const Direction> findPath(const Venue& venue, PosNode from, PosNode to);
+
+	size_t countReachable(const Venue& venue, PosNode from);
+
+	// distance to the food and the room left for all four moves of the head,
+	// with one search from the food and one flood per distinct area
+	MoveSurvey surveyMoves(const Venue& venue);
+
+private:
+	uint32_t indexOf(PosNode pos) const noexcept;
+	bool isPassable(uint32_t index) const noexcept;
+	void nextStamp() noexcept;
+	void bind(const Venue& venue);
+	void breadthFirst(uint32_t source);
+	size_t flood(uint32_t source, uint32_t label);
+
+private:
+	size_t height = 0;
+	size_t width = 0;
+	const MapNode* nodes = nullptr; // of the venue being queried
+	std::vector<std::array<uint32_t, 4>> adjacent; // [index][direction - 1]
+	// a node is visited in the current query only if its stamp is current
+	std::vector<uint32_t> stamps;
+	uint32_t stamp = 0;
+	std::vector<uint32_t> distances;
+	std::vector<uint32_t> parents; // or the area label of floods
+	std::vector<uint32_t> frontier;
+	std::vector<uint64_t> open_list; // heap of (estimate << 32 | index)
+	std::vector<Direction> path;
+};
+
+#endif // SNAKE_PATHFINDER_HEADER_
\ No newline at end of file
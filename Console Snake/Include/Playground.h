@@ -5,8 +5,14 @@
 #include "Interface.h"
 #include "Canvas.h"
 #include "Arena.h"
+#include "FrameScheduler.h"
+#include "BotSession.h"
+#include "FrameExport.h"
+#include <memory>
 #include <atomic>
 #include <chrono>
+#include <mutex>
+#include <condition_variable>
 
 class PlayGround :NotCopyable
 {
@@ -24,12 +30,21 @@ public:
 
 private:
 	void ending();
+	void saveReplay() const noexcept;
+	// wake up the game loop blocked in pausing
+	void changeStatus(GameStatus status);
 
 private:
 	Canvas& canvas;
+	// before arena, which refers to them, so that they are destroyed after it
+	std::unique_ptr<BotSession> bot;
+	std::unique_ptr<FrameExporter> exporter;
 	Arena arena;
+	FrameScheduler frame_scheduler;
 	std::atomic<GameStatus> game_status = GameStatus::Running;
 	std::atomic<bool> opening_flag = false;
+	std::mutex event_mutex;
+	std::condition_variable event_signal;
 };
 
 #endif // SNAKE_PLAYGROUND_HEADER_
\ No newline at end of file
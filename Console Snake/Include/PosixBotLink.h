@@ -0,0 +1,33 @@
+﻿#pragma once
+#ifndef SNAKE_POSIXBOTLINK_HEADER_
+#define SNAKE_POSIXBOTLINK_HEADER_
+
+#include "BotLink.h"
+#include <memory>
+#include <span>
+#include <string>
+#include <sys/types.h>
+
+// BotLink over a UNIX stream socket, POSIX only.
+class PosixBotLink :public BotLink
+{
+public:
+	// run the command (argv style) with its stdin and stdout connected to the link
+	static std::unique_ptr<PosixBotLink> Spawn(std::span<char* const> command);
+	// connect to a bot listening on a UNIX socket
+	static std::unique_ptr<PosixBotLink> Connect(const std::string& socket_path);
+	~PosixBotLink() noexcept;
+
+public:
+	void send(std::string_view data, std::chrono::steady_clock::time_point deadline) override;
+	bool receive(std::string& buffer, std::chrono::steady_clock::time_point deadline) override;
+
+private:
+	PosixBotLink(int socket_fd, pid_t child) noexcept;
+
+private:
+	int socket_fd;
+	pid_t child; // 0 for a connected bot
+};
+
+#endif // SNAKE_POSIXBOTLINK_HEADER_
\ No newline at end of file
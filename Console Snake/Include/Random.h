@@ -6,10 +6,12 @@
 #include <concepts>
 #include <cassert>
 #include <type_traits>
+#include <cstdint>
 
+// each thread owns its engine, so that simulations could run in parallel
 inline auto& GetRandomEngine()
 {
-	static std::default_random_engine engine(std::random_device{}());
+	thread_local std::default_random_engine engine(std::random_device{}());
 	return engine;
 }
 
@@ -18,12 +20,19 @@ inline void ReSeed()
 	GetRandomEngine().seed(std::random_device{}());
 }
 
+// seed for the engines owned by objects, e.g. FastRandom
+inline uint64_t GetRandomSeed()
+{
+	std::random_device device;
+	return static_cast<uint64_t>(device()) << 32 | device();
+}
+
 // random interval: [min,max]
 template<std::integral T1, std::integral T2>
 inline std::common_type_t<T1, T2> GetRandom(T1 min, T2 max)
 {
 	using int_type = std::common_type_t<T1, T2>;
-	static std::uniform_int_distribution<int_type> dis;
+	thread_local std::uniform_int_distribution<int_type> dis;
 	using param_type = typename decltype(dis)::param_type;
 	assert(static_cast<int_type>(min) <= static_cast<int_type>(max));
 	return dis(GetRandomEngine(),
@@ -35,7 +44,7 @@ template<std::floating_point T1, std::floating_point T2>
 inline std::common_type_t<T1, T2> GetRandom(T1 min, T2 max)
 {
 	using float_type = std::common_type_t<T1, T2>;
-	static std::uniform_real_distribution<float_type> dis;
+	thread_local std::uniform_real_distribution<float_type> dis;
 	using param_type = typename decltype(dis)::param_type;
 	assert(static_cast<float_type>(min) < static_cast<float_type>(max));
 	return dis(GetRandomEngine(),
@@ -46,7 +55,7 @@ inline std::common_type_t<T1, T2> GetRandom(T1 min, T2 max)
 template<std::integral T = int, typename Iter>
 inline T GetWeightedDiscreteRandom(Iter first, Iter last)
 {
-	static std::discrete_distribution<T> dis;
+	thread_local std::discrete_distribution<T> dis;
 	using param_type = typename decltype(dis)::param_type;
 	assert(first <= last);
 	return dis(GetRandomEngine(),
@@ -59,7 +68,7 @@ template<std::integral T = int, typename Fn>
 	requires requires(Fn f) { { f(1) } -> std::integral; }
 inline T GetWeightedDiscreteRandom(size_t count, Fn fn)
 {
-	static std::discrete_distribution<T> dis;
+	thread_local std::discrete_distribution<T> dis;
 	using param_type = typename decltype(dis)::param_type;
 	return dis(GetRandomEngine(),
 			   param_type{ count, 0, static_cast<double>(count), fn });
@@ -0,0 +1,71 @@
+﻿#pragma once
+#ifndef SNAKE_REPLAY_HEADER_
+#define SNAKE_REPLAY_HEADER_
+
+#include "Venue.h"
+#include "HeadlessVenue.h"
+#include "DynArray.h"
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+// A game is determined by the map, the seed of its Venue and the direction
+// ordered at each frame, so that is all a replay records.
+struct DirectionRun
+{
+	Direction direction;
+	uint32_t count; // consecutive frames ordering the direction
+};
+
+struct Replay
+{
+	uint64_t seed = 0;
+	DynArray<MapNode, 2> map; // before the snake and food are placed
+	std::vector<DirectionRun> runs;
+
+	size_t getTicks() const noexcept;
+	// re-simulate to the end without observing, on FixedHeadlessVenue for the preset sizes,
+	// return the count of frames played
+	size_t simulate() const;
+	// binary format: see Replay.cpp
+	void save(std::ostream& out) const;
+	static Replay Load(std::istream& in);
+};
+
+class ReplayRecorder
+{
+public:
+	ReplayRecorder(DynArray<MapNode, 2> map, uint64_t seed);
+
+public:
+	void record(Direction direction);
+	const Replay& getReplay() const noexcept;
+
+private:
+	Replay replay;
+};
+
+// Re-simulate a replay on a HeadlessVenue, one frame per step.
+class ReplayPlayer
+{
+public:
+	explicit ReplayPlayer(const Replay& replay);
+
+public:
+	// false when the replay is finished
+	bool step();
+	// play the rest, return the count of frames played
+	size_t playToEnd();
+	bool isFinished() const noexcept;
+	const HeadlessVenue& getVenue() const noexcept;
+
+private:
+	const Replay& replay;
+	HeadlessVenue venue;
+	size_t run_index = 0;
+	uint32_t run_offset = 0;
+};
+
+#endif // SNAKE_REPLAY_HEADER_
\ No newline at end of file
@@ -3,6 +3,7 @@
 #define SNAKE_RESOURCE_HEADER_
 
 #include "Enum.h"
+#include "Element.h"
 #include "LocalizedStrings.h"
 #include "EncryptedString.h"
 #include "WinHeader.h"
@@ -211,16 +212,6 @@ ENUM_DEFINE(Facade)
 };
 
 // --------------- Enum Theme Resource ---------------
-enum struct Element :size_t
-{
-	Blank = 0,
-	Food,
-	Snake,
-	Barrier,
-
-	Mask_
-};
-
 struct ElementSet
 {
 	struct Appearance
@@ -0,0 +1,76 @@
+﻿#pragma once
+#ifndef SNAKE_SESSIONSERVER_HEADER_
+#define SNAKE_SESSIONSERVER_HEADER_
+
+#include "Interface.h"
+#include "GameSession.h"
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Hosts a GameSession for each client of UNIX or TCP sockets in one process (Linux only).
+// One thread runs an epoll reactor: it accepts clients, reads keys and sends output.
+// Every TickInterval, the sessions with a frame due are ticked by a pool of threads,
+// while the reactor waits, so a session is never touched by two threads at once.
+// TCP clients are asked for character mode by telnet negotiation.
+class SessionServer :NotCopyable
+{
+public:
+	// all frame intervals of the game are multiples of it
+	static constexpr std::chrono::milliseconds TickInterval{ 10 };
+
+public:
+	// thread_count 0: use all hardware threads
+	explicit SessionServer(SessionSettings settings, size_t thread_count = 0);
+	~SessionServer();
+
+public:
+	// a stale socket file of the path is replaced, and removed when the server is destroyed
+	void listenUnix(const std::string& path);
+	void listenTcp(uint16_t port);
+	// serve until stop()
+	void run();
+	// from any thread or a signal handler
+	void stop() noexcept;
+	size_t getSessionCount() const noexcept;
+	size_t getThreadCount() const noexcept;
+
+private:
+	struct Connection;
+
+	void addListener(int fd);
+	void accept(int listener);
+	void receive(Connection& connection);
+	// false if the connection is closed
+	bool send(Connection& connection);
+	void close(Connection& connection);
+	void tickSessions();
+	void tickShare(size_t thread_index) noexcept;
+
+private:
+	SessionSettings settings;
+	int epoll_fd = -1;
+	int timer_fd = -1;
+	int stop_fd = -1;
+	std::vector<int> listeners;
+	std::vector<std::string> socket_paths;
+	std::unordered_map<int, std::unique_ptr<Connection>> connections;
+
+	// worker pool, see VenueBatchThreads
+	size_t thread_count;
+	std::vector<Connection*> due;
+	GameSession::Clock::time_point now;
+	std::barrier<> start;
+	std::barrier<> finish;
+	std::atomic<bool> stopping = false;
+	std::vector<std::jthread> threads;
+};
+
+#endif // SNAKE_SESSIONSERVER_HEADER_
\ No newline at end of file
@@ -0,0 +1,38 @@
+﻿#pragma once
+#ifndef SNAKE_SHAREDMEMORY_HEADER_
+#define SNAKE_SHAREDMEMORY_HEADER_
+
+#include "Interface.h"
+#include <memory>
+#include <span>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Named memory shared between processes: POSIX shared memory (PosixSharedMemory.cpp)
+// or a file mapping of the session (WinSharedMemory.cpp).
+class SharedMemory :NotCopyable
+{
+public:
+	// Create a zeroed segment, replacing one of the same name.
+	// The name is removed when the creator is destroyed, mappings of others stay valid.
+	static std::unique_ptr<SharedMemory> Create(const std::string& name, size_t size);
+	// map an existing segment read-only
+	static std::unique_ptr<SharedMemory> Open(const std::string& name);
+	~SharedMemory() noexcept;
+
+public:
+	std::span<std::byte> data() const noexcept;
+
+private:
+	SharedMemory(std::string name, void* address, size_t size, intptr_t handle, bool owner) noexcept;
+
+private:
+	std::string name;
+	void* address;
+	size_t size;
+	intptr_t handle; // file descriptor or HANDLE
+	bool owner;
+};
+
+#endif // SNAKE_SHAREDMEMORY_HEADER_
\ No newline at end of file
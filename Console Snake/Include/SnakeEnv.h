@@ -0,0 +1,76 @@
+﻿#pragma once
+#ifndef SNAKE_SNAKEENV_HEADER_
+#define SNAKE_SNAKEENV_HEADER_
+
+/*
+ * C interface of a headless game with its observation written into memory of the caller,
+ * for training processes in other languages (e.g. through ctypes or cffi over a numpy array).
+ * Built as the shared library SnakeEnv by CMake. SNAKE_ENV_ABI_VERSION is raised whenever
+ * a function is added or changed, so callers can check snake_env_abi_version().
+ * Version 2: snake_env_reset returns whether it succeeded.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#	if defined(SNAKE_ENV_EXPORTS)
+#		define SNAKE_ENV_API __declspec(dllexport)
+#	else
+#		define SNAKE_ENV_API __declspec(dllimport)
+#	endif
+#else
+#	define SNAKE_ENV_API __attribute__((visibility("default")))
+#endif
+
+#define SNAKE_ENV_ABI_VERSION 2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* observation layouts, see ObservationEncoder.h */
+#define SNAKE_OBSERVATION_PLANES 0 /* 5 planes of uint8_t: barrier, body, head, food, tail */
+#define SNAKE_OBSERVATION_GRID 1   /* int8_t: blank 0, barrier 1, body 2, head 3, food 4, tail 5 */
+
+/* directions, SNAKE_DIRECTION_NONE keeps the direction */
+#define SNAKE_DIRECTION_NONE 0
+#define SNAKE_DIRECTION_UP 1
+#define SNAKE_DIRECTION_LEFT 2
+#define SNAKE_DIRECTION_RIGHT 3
+#define SNAKE_DIRECTION_DOWN 4
+
+typedef struct SnakeEnv SnakeEnv;
+
+SNAKE_ENV_API uint32_t snake_env_abi_version(void);
+/* bytes of the observation, 0 for an unknown layout */
+SNAKE_ENV_API size_t snake_env_observation_size(uint32_t height, uint32_t width, int layout);
+
+/*
+ * map: height * width bytes, row by row, nonzero for barriers.
+ * observation: observation_size bytes at least, written on create, reset and every step,
+ * and must outlive the env.
+ * Returns NULL if the map or the buffer is invalid.
+ */
+SNAKE_ENV_API SnakeEnv* snake_env_create(const uint8_t* map, uint32_t height, uint32_t width,
+										 uint64_t seed, int layout, void* observation, size_t observation_size);
+SNAKE_ENV_API void snake_env_destroy(SnakeEnv* env);
+
+/*
+ * start a new game, the same seed and directions always play the same game.
+ * Returns 0, or -1 if out of memory, then the game before is kept.
+ */
+SNAKE_ENV_API int snake_env_reset(SnakeEnv* env, uint64_t seed);
+/*
+ * reward (may be NULL): 1 for food, -1 for a crash, 0 otherwise.
+ * Returns 1 if the game is over (crashed or won), then steps do nothing until reset.
+ */
+SNAKE_ENV_API int snake_env_step(SnakeEnv* env, int direction, float* reward);
+SNAKE_ENV_API uint32_t snake_env_score(const SnakeEnv* env);
+SNAKE_ENV_API uint32_t snake_env_ticks(const SnakeEnv* env);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SNAKE_SNAKEENV_HEADER_ */
\ No newline at end of file
@@ -0,0 +1,32 @@
+﻿#pragma once
+#ifndef SNAKE_SOLVER_HEADER_
+#define SNAKE_SOLVER_HEADER_
+
+#include "Interface.h"
+#include "Venue.h"
+#include "PathFinder.h"
+#include <string_view>
+#include <cstddef>
+
+// Autopilot of the snake, decides the direction before every frame.
+// A solver may keep state between frames, so one solver serves one game at a time.
+class Solver :public Interface
+{
+public:
+	virtual Direction solveNextStep(const Venue& venue) = 0;
+	virtual std::wstring_view name() const noexcept = 0;
+};
+
+// Head for the food along the shortest path,
+// avoiding the moves that leave less room than the snake length.
+class GreedySolver :public Solver
+{
+public:
+	Direction solveNextStep(const Venue& venue) override;
+	std::wstring_view name() const noexcept override;
+
+private:
+	PathFinder path_finder;
+};
+
+#endif // SNAKE_SOLVER_HEADER_
\ No newline at end of file
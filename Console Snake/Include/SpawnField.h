@@ -0,0 +1,55 @@
+﻿#pragma once
+#ifndef SNAKE_SPAWNFIELD_HEADER_
+#define SNAKE_SPAWNFIELD_HEADER_
+
+#include "Interface.h"
+#include "Venue.h"
+#include "AliasTable.h"
+#include "FastRandom.h"
+#include <memory>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+// Where the snake starts on a map: blank nodes weighted by the blank nodes
+// within two steps around, and the directions by the room behind the head.
+// Depends only on the layout of blank nodes, so it is computed once and shared.
+class SpawnField :NotCopyable
+{
+public:
+	struct Spawn
+	{
+		PosNode pos;
+		Direction direct;
+	};
+
+public:
+	explicit SpawnField(const DynArray<MapNode, 2>& map);
+	// cached by the layout of blank nodes for all threads, the last 16 layouts used
+	static std::shared_ptr<const SpawnField> Get(const DynArray<MapNode, 2>& map);
+
+public:
+	// empty if the map has no blank node
+	std::optional<Spawn> sample(FastRandom& engine) const noexcept;
+	bool isLayoutOf(const DynArray<MapNode, 2>& map) const;
+
+private:
+	static constexpr size_t DirectCount = 4;
+	struct Node
+	{
+		PosNode pos;
+		uint16_t direct_weights[DirectCount];
+		uint16_t direct_total;
+	};
+	static std::vector<uint64_t> GetBlankBits(const DynArray<MapNode, 2>& map);
+
+private:
+	size_t height;
+	size_t width;
+	std::vector<uint64_t> blank_bits; // [(y * width + x) / 64]
+	std::vector<Node> nodes;
+	AliasTable node_table;
+};
+
+#endif // SNAKE_SPAWNFIELD_HEADER_
\ No newline at end of file
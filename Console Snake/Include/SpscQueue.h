@@ -0,0 +1,69 @@
+﻿#pragma once
+#ifndef SNAKE_SPSCQUEUE_HEADER_
+#define SNAKE_SPSCQUEUE_HEADER_
+
+#include "Interface.h"
+#include <atomic>
+#include <optional>
+#include <type_traits>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+template<typename T, size_t Capacity>
+class SpscQueue :NotCopyable
+{
+	static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2.");
+	static_assert(std::is_trivially_copyable_v<T>);
+	static constexpr size_t CacheLineSize = 64;
+
+public:
+	SpscQueue() = default;
+
+public:
+	// producer side, return false when the queue is full
+	bool push(const T& value) noexcept
+	{
+		size_t tail = tail_index.load(std::memory_order_relaxed);
+		if (tail - head_cache == Capacity)
+		{
+			head_cache = head_index.load(std::memory_order_acquire);
+			if (tail - head_cache == Capacity)
+				return false;
+		}
+		slots[tail & (Capacity - 1)] = value;
+		tail_index.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer side
+	std::optional<T> pop() noexcept
+	{
+		size_t head = head_index.load(std::memory_order_relaxed);
+		if (head == tail_cache)
+		{
+			tail_cache = tail_index.load(std::memory_order_acquire);
+			if (head == tail_cache)
+				return std::nullopt;
+		}
+		T value = slots[head & (Capacity - 1)];
+		head_index.store(head + 1, std::memory_order_release);
+		return value;
+	}
+
+	// consumer side
+	void clear() noexcept
+	{
+		tail_cache = tail_index.load(std::memory_order_acquire);
+		head_index.store(tail_cache, std::memory_order_release);
+	}
+
+private:
+	// indices only increase, the slot is index % Capacity
+	alignas(CacheLineSize) std::atomic<size_t> head_index = 0;
+	size_t tail_cache = 0; // consumer's copy of tail_index
+	alignas(CacheLineSize) std::atomic<size_t> tail_index = 0;
+	size_t head_cache = 0; // producer's copy of head_index
+	alignas(CacheLineSize) T slots[Capacity] = {};
+};
+
+#endif // SNAKE_SPSCQUEUE_HEADER_
\ No newline at end of file
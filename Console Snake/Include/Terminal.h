@@ -0,0 +1,26 @@
+﻿#pragma once
+#ifndef SNAKE_TERMINAL_HEADER_
+#define SNAKE_TERMINAL_HEADER_
+
+#include "Interface.h"
+#include <string_view>
+#include <cstdint>
+
+// Output backend of Canvas and Console.
+// Operations may be buffered until flush(), coordinates are in character cells
+// and colors are console attributes (foreground in low 4 bits, background in high 4 bits).
+class Terminal :public Interface
+{
+public:
+	virtual void setColor(uint16_t attribute) = 0;
+	virtual void setCursor(short column, short row) = 0;
+	virtual void write(std::wstring_view str) = 0;
+	virtual void setCursorVisible(bool visible) = 0;
+	virtual void setTitle(std::wstring_view title) = 0;
+	// side effect: clear screen
+	virtual void resize(short columns, short rows) = 0;
+	virtual void clear() = 0;
+	virtual void flush() = 0;
+};
+
+#endif // SNAKE_TERMINAL_HEADER_
\ No newline at end of file
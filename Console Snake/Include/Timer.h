@@ -2,52 +2,83 @@
 #ifndef SNAKE_TIMER_HEADER_
 #define SNAKE_TIMER_HEADER_
 
-#include "ScopeGuard.h"
+#include "Interface.h"
 #include <utility>
 #include <chrono>
 #include <thread>
-#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <unordered_map>
+#include <queue>
+#include <vector>
 #include <concepts>
+#include <cstddef>
+
+// One worker thread for all timers, sleeping until the nearest deadline.
+// Deadlines are kept in a min-heap, reset and disable don't touch the heap:
+// stale entries are fixed up or dropped when they reach the top.
+class TimerService :NotCopyable
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using Task = std::function<void()>;
+
+public:
+	static TimerService& get();
+
+public:
+	size_t add(Task f, Task callback, Clock::duration delay, bool looping);
+	// the timer will be fired after the whole delay from now
+	void reset(size_t id) noexcept;
+	// wait for the running f() of the timer, then call the callback on this thread
+	void disable(size_t id) noexcept;
+	void loop(size_t id, bool looping) noexcept;
+
+private:
+	TimerService();
+	~TimerService() noexcept;
+	void work() noexcept;
+
+private:
+	struct Slot
+	{
+		Task f;
+		Task callback;
+		Clock::duration delay;
+		Clock::time_point deadline;
+		bool looping;
+		bool enabled = true;
+	};
+	using Deadline = std::pair<Clock::time_point, size_t>;
+
+	std::mutex mutex;
+	std::condition_variable wakeup_signal;
+	std::condition_variable finish_signal;
+	std::unordered_map<size_t, Slot> slots;
+	std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>> deadlines;
+	size_t next_id = 1;
+	size_t running_id = 0; // 0 for none
+	bool stopping = false;
+	std::thread worker;
+};
 
 class Timer
 {
 	static constexpr void NoCallback() noexcept {}
 public:
-	static constexpr std::chrono::milliseconds MinimumInterval{ 1 };
 	enum Looping :bool { NoLoop = false, Loop = true };
 
 public:
+	// f and callback are called on the thread of TimerService,
+	// except that disable() calls the callback on its caller
 	template<std::invocable F, typename Rep, typename Period, std::invocable Callback = decltype(NoCallback)>
 	Timer(F&& f, std::chrono::duration<Rep, Period> delay,
 		  Looping looping = NoLoop, Callback&& callback = NoCallback)
+		: id(TimerService::get().add(std::forward<F>(f), std::forward<Callback>(callback),
+									  std::chrono::duration_cast<TimerService::Clock::duration>(delay), looping))
 	{
-		control->timer_loop = looping;
-		std::thread(
-			[=, control = control, f = std::move(f), callback = std::move(callback)]() noexcept
-			{
-				using namespace std::chrono;
-				finally {
-					callback();
-				};
-				do {
-					auto end = high_resolution_clock::now() + delay;
-					do {
-						std::this_thread::sleep_for(MinimumInterval);
-						if (!control->timer_enable)
-							return;
-						if (control->timer_reset)
-						{
-							control->timer_reset = false;
-							end = high_resolution_clock::now() + delay;
-						}
-					} while (high_resolution_clock::now() < end);
-
-					if (control->timer_enable)
-						f();
-					else
-						[[unlikely]] return;
-				} while (control->timer_loop);
-			}).detach();
+
 	}
 
 	~Timer() noexcept
@@ -61,26 +92,21 @@ public:
 public:
 	void disable() noexcept
 	{
-		control->timer_enable = false;
+		TimerService::get().disable(id);
 	}
 
 	void reset() noexcept
 	{
-		control->timer_reset = true;
+		TimerService::get().reset(id);
 	}
 
 	void loop(bool looping) noexcept
 	{
-		control->timer_loop = looping;
+		TimerService::get().loop(id, looping);
 	}
 
 private:
-	struct Control {
-		bool timer_enable = true;
-		bool timer_reset = false;
-		bool timer_loop = false;
-	};
-	std::shared_ptr<Control> control = std::make_shared<Control>();
+	size_t id;
 };
 
 #endif // SNAKE_TIMER_HEADER_
\ No newline at end of file
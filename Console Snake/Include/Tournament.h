@@ -0,0 +1,73 @@
+﻿#pragma once
+#ifndef SNAKE_TOURNAMENT_HEADER_
+#define SNAKE_TOURNAMENT_HEADER_
+
+#include "Interface.h"
+#include "Solver.h"
+#include "Venue.h"
+#include "DynArray.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+struct TournamentResult
+{
+	std::wstring solver_name;
+	size_t games = 0;
+	size_t wins = 0;
+	size_t total_score = 0;
+	size_t total_moves = 0;
+	double seconds = 0.0; // sum of the time spent on each game
+
+	double averageScore() const noexcept;
+	double winRate() const noexcept;
+	double movesPerSecond() const noexcept;
+};
+
+// Play games of every solver on the same map across threads.
+// Each game is a job with its own HeadlessVenue and solver, idle threads
+// steal jobs from the others so that long games don't hold up the run.
+class Tournament :NotCopyable
+{
+public:
+	using SolverFactory = std::function<std::unique_ptr<Solver>()>;
+
+public:
+	// thread_count 0: use all hardware threads
+	// stall_limit 0: the game is over after map.total_size() * 4 frames without food
+	Tournament(DynArray<MapNode, 2> map, size_t games_per_solver,
+			   size_t thread_count = 0, size_t stall_limit = 0);
+
+public:
+	void addSolver(SolverFactory factory);
+	// game i of every solver is played with seed + i, random by default
+	void setSeed(uint64_t new_seed) noexcept;
+	std::vector<TournamentResult> run() const;
+
+private:
+	struct Job
+	{
+		size_t solver_index;
+		uint64_t seed;
+	};
+	struct GameResult
+	{
+		size_t score;
+		size_t moves;
+		bool win;
+	};
+	GameResult playGame(Solver& solver, uint64_t seed) const;
+
+private:
+	DynArray<MapNode, 2> map;
+	std::vector<SolverFactory> factories;
+	size_t games_per_solver;
+	size_t thread_count;
+	size_t stall_limit;
+	uint64_t seed;
+};
+
+#endif // SNAKE_TOURNAMENT_HEADER_
\ No newline at end of file
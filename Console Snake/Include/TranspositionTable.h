@@ -0,0 +1,83 @@
+﻿#pragma once
+#ifndef SNAKE_TRANSPOSITIONTABLE_HEADER_
+#define SNAKE_TRANSPOSITIONTABLE_HEADER_
+
+#include "Interface.h"
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+// Fixed-size hash table from state hashes (see Venue::getStateHash) to small values,
+// for deduplicating states in search and analysis. Newer entries replace older ones
+// in the same slot. Threads may find and store at the same time without locks:
+// each slot keeps the key XORed with the value, so a torn slot is read as a miss.
+// Key 0 is reserved for empty slots.
+template<typename T>
+class TranspositionTable :NotCopyable
+{
+	static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(uint64_t));
+
+public:
+	// capacity is rounded up to a power of 2
+	explicit TranspositionTable(size_t capacity)
+		: mask(std::bit_ceil(capacity < 2 ? 2 : capacity) - 1)
+		, slots(std::make_unique<Slot[]>(mask + 1))
+	{
+
+	}
+
+public:
+	std::optional<T> find(uint64_t key) const noexcept
+	{
+		const Slot& slot = slots[key & mask];
+		uint64_t check = slot.check.load(std::memory_order_relaxed);
+		uint64_t data = slot.data.load(std::memory_order_relaxed);
+		if (key == 0 || (check ^ data) != key)
+			return std::nullopt;
+		T value;
+		std::memcpy(&value, &data, sizeof(T));
+		return value;
+	}
+
+	void store(uint64_t key, const T& value) noexcept
+	{
+		if (key == 0)
+			return;
+		uint64_t data = 0;
+		std::memcpy(&data, &value, sizeof(T));
+		Slot& slot = slots[key & mask];
+		slot.check.store(key ^ data, std::memory_order_relaxed);
+		slot.data.store(data, std::memory_order_relaxed);
+	}
+
+	// not thread safe
+	void clear() noexcept
+	{
+		for (size_t index = 0; index <= mask; index++)
+		{
+			slots[index].check.store(0, std::memory_order_relaxed);
+			slots[index].data.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	size_t capacity() const noexcept
+	{
+		return mask + 1;
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<uint64_t> check{ 0 };
+		std::atomic<uint64_t> data{ 0 };
+	};
+	size_t mask;
+	std::unique_ptr<Slot[]> slots;
+};
+
+#endif // SNAKE_TRANSPOSITIONTABLE_HEADER_
\ No newline at end of file
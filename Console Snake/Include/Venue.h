@@ -0,0 +1,197 @@
+﻿#pragma once
+#ifndef SNAKE_VENUE_HEADER_
+#define SNAKE_VENUE_HEADER_
+
+#include "Element.h"
+#include "DynArray.h"
+#include "CellStorage.h"
+#include "OccupancyBoard.h"
+#include "FastRandom.h"
+#include <optional>
+#include <concepts>
+#include <span>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+struct Direction
+{
+	enum Tags
+	{
+		None = 0,
+		Up = 1,
+		Left = 2,
+		Right = 3,
+		Down = 4,
+		Conflict = 5,
+	};
+
+	constexpr Direction() noexcept :value(None) {}
+	constexpr Direction(Tags tag) noexcept :value(tag) {}
+
+	friend constexpr bool operator==(Direction, Direction) = default;
+	friend constexpr Tags operator+(Direction direction) noexcept // for twice type conversion
+	{
+		return direction.value;
+	}
+	friend constexpr Direction operator+(Tags tag) noexcept // for twice type conversion
+	{
+		return tag;
+	}
+	friend constexpr Direction operator-(Direction direction) noexcept
+	{
+		return Tags(Direction::Conflict - direction.value);
+	}
+
+	constexpr bool isConflictWith(Direction other) const noexcept
+	{
+		return this->value + other.value == Conflict;
+	}
+
+private:
+	Tags value;
+};
+
+// Coord is uint8_t for Venue, wider ones for large maps (see LargeVenue)
+template<std::unsigned_integral Coord>
+struct BasicPosNode
+{
+	Coord x;
+	Coord y;
+
+	friend constexpr bool operator==(BasicPosNode, BasicPosNode) = default;
+};
+using PosNode = BasicPosNode<uint8_t>;
+
+template<std::unsigned_integral Coord>
+struct BasicPosNodeGroup
+{
+	size_t count;
+	BasicPosNode<Coord> head_pos;
+	BasicPosNode<Coord> tail_pos;
+};
+using PosNodeGroup = BasicPosNodeGroup<uint8_t>;
+
+// The game logic of one snake, map nodes stored as Storage (see CellStorage.h).
+// Instantiated for PackedCells (Venue), CellPlanes and FixedCells of the preset sizes in Venue.cpp.
+template<CellStorage Storage>
+class BasicVenue
+{
+	static constexpr int SnakeIntendedInitLength = 3;
+public:
+	BasicVenue(DynArray<MapNode, 2> map);
+	// the same seed and inputs always play the same game
+	BasicVenue(DynArray<MapNode, 2> map, uint64_t seed);
+
+public:
+	PosNode getNextPosition() const noexcept;
+	PosNode getAdjacentPosition(PosNode pos, Direction direct) const noexcept;
+	PosNode getSnakeHead() const noexcept;
+	PosNode getSnakeTail() const noexcept;
+	Direction getSnakeDirection() const noexcept;
+	size_t getSnakeLength() const noexcept;
+	std::optional<PosNode> getFoodPosition() const noexcept;
+	Element getPositionType(uint8_t x, uint8_t y) const noexcept;
+	size_t getHeight() const noexcept;
+	size_t getWidth() const noexcept;
+	// only for storages of MapNode
+	const DynArray<MapNode, 2>& getCurrentMap() const noexcept
+		requires requires(const Storage& cells) { cells.getNodes(); }
+	{
+		return cells.getNodes();
+	}
+	// count of Blank nodes, which are neither snake nor food
+	size_t getBlankCount() const noexcept;
+	// count of non-barrier and non-snake nodes reachable from (x, y)
+	size_t getReachableCount(uint8_t x, uint8_t y) const noexcept;
+
+	// Copy the whole state into a flat buffer of getSnapshotSize() bytes and back,
+	// see VenueSnapshot and SnapshotArena. Only for venues on the same map.
+	size_t getSnapshotSize() const noexcept;
+	void snapshot(std::span<std::byte> buffer) const noexcept;
+	void restore(std::span<const std::byte> buffer) noexcept;
+
+	// Zobrist hash of the snake body, food and direction, kept up to date on every change,
+	// so equal states from different games can be found in a TranspositionTable.
+	// The random engine is not part of it, so states equal by hash may spawn different food.
+	uint64_t getStateHash() const noexcept;
+	// the same hash computed from scratch
+	uint64_t computeStateHash() const noexcept;
+
+protected:
+	std::optional<PosNode> generateFood();
+
+	void orderDirection(Direction) noexcept;
+	PosNodeGroup updateFrame() noexcept;
+
+	bool isWin(size_t score) const noexcept;
+
+private:
+	void setupInvariant() noexcept;
+	void setNodeType(uint8_t x, uint8_t y, Element type) noexcept;
+	void createSnake(const DynArray<MapNode, 2>& map);
+	void addSnakeBody(Direction head_direct, uint8_t head_x, uint8_t head_y) noexcept;
+	void addSnakeBody(Direction tail_direct) noexcept;
+	void rebindData(int16_t snake_index, uint8_t map_x, uint8_t map_y) noexcept;
+	void forwardIndex(int16_t& index) const noexcept;
+	void backwardIndex(int16_t& index) const noexcept;
+	void nextPosition(uint8_t& x, uint8_t& y, Direction) const noexcept;
+
+private:
+	// the fixed-size part of snapshots, followed by cells, snake_body and occupancy
+	struct SnapshotHeader
+	{
+		size_t map_size;
+		int16_t snake_head_index;
+		int16_t snake_tail_index;
+		size_t snake_init_length;
+		Direction snake_direct;
+		bool has_food;
+		PosNode food;
+		uint64_t state_hash;
+		FastRandom random_engine;
+	};
+	// The invariant of this class is that ALL map nodes except barrier
+	// and snake_body nodes should have one-to-one correspondence.
+	Storage cells;
+	// Mirror of map node types, only for maps no wider than OccupancyBoard::MaxWidth.
+	// Node types must be changed through setNodeType() to keep them in sync.
+	std::optional<OccupancyBoard> occupancy;
+	DynArray<PosNode> snake_body;
+	int16_t snake_head_index = -1;
+	int16_t snake_tail_index = -1;
+	size_t snake_init_length = 0;
+
+	Direction snake_direct = Direction::None;
+	std::optional<PosNode> food;
+	uint64_t state_hash = 0;
+	FastRandom random_engine; // owned by the venue, so that venues can run on any threads
+};
+
+extern template class BasicVenue<PackedCells>;
+extern template class BasicVenue<CellPlanes>;
+extern template class BasicVenue<FixedCells<15, 15>>;
+extern template class BasicVenue<FixedCells<20, 20>>;
+extern template class BasicVenue<FixedCells<24, 24>>;
+using Venue = BasicVenue<PackedCells>;
+// for the preset map sizes of 15, 20 and 24
+template<size_t Size>
+using FixedVenue = BasicVenue<FixedCells<Size, Size>>;
+
+// Build the map of Venue from a sequence of Elements, e.g. MapShape.
+template<typename Shape>
+inline DynArray<MapNode, 2> MakeVenueMap(const Shape& shape, size_t height, size_t width)
+{
+	DynArray<MapNode, 2> map(height, width);
+	assert(map.total_size() == shape.size());
+	std::transform(shape.begin(), shape.end(), map.iter_all().begin(),
+				   [](Element type)
+				   {
+					   MapNode node{ .type = type };
+					   return node;
+				   });
+	return map;
+}
+
+#endif // SNAKE_VENUE_HEADER_
\ No newline at end of file
@@ -0,0 +1,147 @@
+﻿#pragma once
+#ifndef SNAKE_VENUEBATCH_HEADER_
+#define SNAKE_VENUEBATCH_HEADER_
+
+#include "Interface.h"
+#include "Venue.h"
+#include "SpawnField.h"
+#include "FastRandom.h"
+#include <memory>
+#include <optional>
+#include <vector>
+#include <span>
+#include <thread>
+#include <barrier>
+#include <cstdint>
+#include <cstddef>
+
+// Many single-snake games on the same map, stepped in lockstep, for reinforcement learning.
+// The state is kept as structure of arrays: board k is the k-th height * width slice
+// of one array of elements, so the boards of all games are one observation array,
+// and rewards and done flags of a step are contiguous too.
+// The rules are those of HeadlessVenue. A game which is over is reset in the same step,
+// with done set, so every step() gives an observation of a running game.
+class VenueBatch :NotCopyable
+{
+public:
+	static constexpr size_t SnakeInitLength = 3;
+	// Games are stepped in shards of fixed ranges, a thread per shard at a time,
+	// see VenueBatchThreads.
+	static constexpr size_t ShardSize = 64;
+
+public:
+	// Game k is seeded with seed + k, and reseeded with seed + k + batch_size * episode.
+	// stall_limit 0: a game is over after height * width * 4 steps without food
+	VenueBatch(const DynArray<MapNode, 2>& map, size_t batch_size, uint64_t seed, size_t stall_limit = 0);
+
+public:
+	// one direction for each game, Direction::None keeps the direction
+	void step(std::span<const Direction> actions) noexcept;
+	void stepShard(size_t shard, std::span<const Direction> actions) noexcept;
+	void reset(size_t game) noexcept;
+
+	size_t size() const noexcept;
+	size_t getShardCount() const noexcept;
+	size_t getHeight() const noexcept;
+	size_t getWidth() const noexcept;
+
+	// [game][y][x]
+	std::span<const Element> getBoards() const noexcept;
+	std::span<const Element> getBoard(size_t game) const noexcept;
+	// of the last step: 1 for food (and a win), -1 for a crash, 0 otherwise
+	std::span<const float> getRewards() const noexcept;
+	// of the last step: the game was over and has been reset
+	std::span<const uint8_t> getDones() const noexcept;
+	// of the running episodes
+	std::span<const uint32_t> getScores() const noexcept;
+	std::span<const uint32_t> getTicks() const noexcept;
+	// of the episode ended by the last step where done is set, kept until the next one ends
+	std::span<const uint32_t> getFinalScores() const noexcept;
+	std::span<const uint32_t> getFinalTicks() const noexcept;
+
+	PosNode getSnakeHead(size_t game) const noexcept;
+	Direction getSnakeDirection(size_t game) const noexcept;
+	size_t getSnakeLength(size_t game) const noexcept;
+	std::optional<PosNode> getFoodPosition(size_t game) const noexcept;
+
+private:
+	// cells are numbered y * width + x, so 16 bits hold all maps of Venue
+	using CellIndex = uint16_t;
+	static constexpr CellIndex NoFood = UINT16_MAX;
+
+	void stepGame(size_t game, Direction action) noexcept;
+	// keep the results of the episode, then reset
+	void finishEpisode(size_t game) noexcept;
+	void generateFood(size_t game) noexcept;
+	void rebindData(size_t game, CellIndex ring_index, CellIndex cell) noexcept;
+	CellIndex forwardIndex(CellIndex index) const noexcept;
+	CellIndex backwardIndex(CellIndex index) const noexcept;
+	PosNode toPosition(CellIndex cell) const noexcept;
+
+private:
+	size_t height;
+	size_t width;
+	size_t cell_count;
+	size_t free_count; // non-barrier nodes
+	size_t batch_size;
+	size_t stall_limit;
+	uint64_t seed;
+	std::shared_ptr<const SpawnField> spawn_field;
+	std::vector<CellIndex> neighbors; // [cell][direction - 1]
+
+	// initial state of a board
+	std::vector<Element> blank_types;
+	std::vector<CellIndex> blank_ring;
+	std::vector<CellIndex> blank_ring_indices;
+
+	// [game][cell], the invariant of Venue for each game: ring holds the snake
+	// from tail_index to head_index and free nodes elsewhere, ring_indices is its inverse
+	std::vector<Element> types;
+	std::vector<CellIndex> ring_indices;
+	// [game][ring index]
+	std::vector<CellIndex> ring;
+
+	// [game]
+	std::vector<CellIndex> head_indices;
+	std::vector<CellIndex> tail_indices;
+	std::vector<Direction> directions;
+	std::vector<CellIndex> foods;
+	std::vector<uint32_t> scores;
+	std::vector<uint32_t> ticks;
+	std::vector<uint32_t> final_scores;
+	std::vector<uint32_t> final_ticks;
+	std::vector<uint32_t> stalls;
+	std::vector<uint32_t> episodes;
+	std::vector<FastRandom> random_engines;
+	std::vector<float> rewards;
+	std::vector<uint8_t> dones;
+};
+
+// Threads stepping a VenueBatch: thread i always steps shards i, i + n, i + 2n...,
+// so a shard stays in the cache of one core. The calling thread is thread 0.
+class VenueBatchThreads :NotCopyable
+{
+public:
+	// thread_count 0: use all hardware threads, never more than the shards
+	explicit VenueBatchThreads(VenueBatch& batch, size_t thread_count = 0);
+	~VenueBatchThreads();
+
+public:
+	// the same as batch.step(actions), returns when all shards are stepped
+	void step(std::span<const Direction> actions) noexcept;
+	size_t getThreadCount() const noexcept;
+
+private:
+	void stepShards(size_t thread_index) noexcept;
+
+private:
+	VenueBatch& batch;
+	size_t thread_count;
+	std::span<const Direction> actions;
+	bool stopping = false;
+	std::barrier<> start;
+	std::barrier<> finish;
+	std::vector<std::jthread> threads;
+};
+
+#endif // SNAKE_VENUEBATCH_HEADER_
\ No newline at end of file
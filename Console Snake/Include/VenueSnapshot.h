@@ -0,0 +1,78 @@
+﻿#pragma once
+#ifndef SNAKE_VENUESNAPSHOT_HEADER_
+#define SNAKE_VENUESNAPSHOT_HEADER_
+
+#include "Interface.h"
+#include <span>
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+// The whole state of a Venue (or HeadlessVenue) as one flat block of bytes,
+// so that cloning a game is a single memcpy. Only valid for venues on the same map.
+class VenueSnapshot
+{
+public:
+	VenueSnapshot() noexcept = default;
+	explicit VenueSnapshot(size_t size);
+	VenueSnapshot(const VenueSnapshot& other);
+	VenueSnapshot(VenueSnapshot&& other) noexcept;
+	VenueSnapshot& operator=(const VenueSnapshot& other);
+	VenueSnapshot& operator=(VenueSnapshot&& other) noexcept;
+
+	template<typename V>
+	static VenueSnapshot Take(const V& venue)
+	{
+		VenueSnapshot snapshot(venue.getSnapshotSize());
+		venue.snapshot(snapshot.data());
+		return snapshot;
+	}
+
+public:
+	// reuse the buffer if it is large enough
+	template<typename V>
+	void capture(const V& venue)
+	{
+		resize(venue.getSnapshotSize());
+		venue.snapshot(data());
+	}
+	std::span<std::byte> data() noexcept;
+	std::span<const std::byte> data() const noexcept;
+	size_t size() const noexcept;
+
+private:
+	void resize(size_t new_size);
+
+private:
+	std::unique_ptr<std::byte[]> buffer;
+	size_t buffer_size = 0;
+	size_t buffer_capacity = 0;
+};
+
+// Fixed-size snapshot buffers carved from large blocks and recycled through
+// a free list, so that search loops take and drop snapshots without heap traffic.
+class SnapshotArena :NotCopyable
+{
+	static constexpr size_t SlotAlignment = 64;
+public:
+	// snapshot_size: getSnapshotSize() of the venues, slots_per_block: slots allocated at once
+	SnapshotArena(size_t snapshot_size, size_t slots_per_block = 1024);
+
+public:
+	std::span<std::byte> acquire();
+	void release(std::span<std::byte> slot) noexcept;
+	size_t getSnapshotSize() const noexcept;
+	size_t getSlotCount() const noexcept;
+
+private:
+	void grow();
+
+private:
+	size_t snapshot_size;
+	size_t slot_stride;
+	size_t slots_per_block;
+	std::vector<std::unique_ptr<std::byte[]>> blocks;
+	std::vector<std::byte*> free_slots;
+};
+
+#endif // SNAKE_VENUESNAPSHOT_HEADER_
\ No newline at end of file
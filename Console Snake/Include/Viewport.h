@@ -0,0 +1,91 @@
+﻿#pragma once
+#ifndef SNAKE_VIEWPORT_HEADER_
+#define SNAKE_VIEWPORT_HEADER_
+
+#include "Venue.h"
+#include "FrameBuffer.h"
+#include <span>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+
+// Window of a map larger than the screen, scrolled to keep a node at least
+// margin nodes away from its edges. Maps wrap around, so does the window.
+template<std::unsigned_integral Coord>
+class BasicViewport
+{
+public:
+	using Position = BasicPosNode<Coord>;
+
+	BasicViewport(size_t map_height, size_t map_width, size_t height, size_t width, size_t margin) noexcept
+		: map_height(map_height), map_width(map_width),
+		view_height(std::min(height, map_height)), view_width(std::min(width, map_width)),
+		margin(margin)
+	{}
+
+public:
+	void follow(Position pos) noexcept
+	{
+		origin_y = scroll(origin_y, pos.y, view_height, map_height);
+		origin_x = scroll(origin_x, pos.x, view_width, map_width);
+	}
+	void center(Position pos) noexcept
+	{
+		origin_y = (pos.y + map_height - view_height / 2) % map_height;
+		origin_x = (pos.x + map_width - view_width / 2) % map_width;
+	}
+	Position getOrigin() const noexcept
+	{
+		return { static_cast<Coord>(origin_x), static_cast<Coord>(origin_y) };
+	}
+	size_t height() const noexcept
+	{
+		return view_height;
+	}
+	size_t width() const noexcept
+	{
+		return view_width;
+	}
+
+	// Draw the window at the top left of the frame, two columns per node.
+	// type_of(Position) gives the Element of map nodes.
+	template<typename TypeOf>
+	void draw(FrameBuffer& frame, TypeOf&& type_of) const
+	{
+		for (size_t row = 0; row < view_height; row++)
+		{
+			Coord y = static_cast<Coord>((origin_y + row) % map_height);
+			for (size_t column = 0; column < view_width; column++)
+			{
+				Coord x = static_cast<Coord>((origin_x + column) % map_width);
+				DrawElementCell(frame, column, row, type_of(Position{ x, y }));
+			}
+		}
+	}
+
+private:
+	// the new origin of one axis
+	size_t scroll(size_t origin, size_t pos, size_t view, size_t map) const noexcept
+	{
+		size_t keep = std::min(margin, (view - 1) / 2);
+		size_t offset = (pos + map - origin) % map;
+		if (offset < keep)
+			return (pos + map - keep) % map;
+		if (offset > view - 1 - keep)
+			return (pos + map - (view - 1 - keep)) % map;
+		return origin;
+	}
+
+private:
+	size_t map_height;
+	size_t map_width;
+	size_t view_height;
+	size_t view_width;
+	size_t margin;
+	size_t origin_x = 0;
+	size_t origin_y = 0;
+};
+
+using Viewport = BasicViewport<uint8_t>;
+
+#endif // SNAKE_VIEWPORT_HEADER_
\ No newline at end of file
@@ -0,0 +1,68 @@
+﻿#pragma once
+#ifndef SNAKE_VIRTUALTERMINAL_HEADER_
+#define SNAKE_VIRTUALTERMINAL_HEADER_
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// VT escape sequences appended to an output buffer.
+namespace VirtualTerminal {
+	inline void AppendNumber(std::wstring& out, int number)
+	{
+		out += std::to_wstring(number);
+	}
+
+	inline void AppendCursor(std::wstring& out, short column, short row)
+	{
+		out += L"\x1b[";
+		AppendNumber(out, row + 1);
+		out += L';';
+		AppendNumber(out, column + 1);
+		out += L'H';
+	}
+
+	// console attribute: bit 0 blue, bit 1 green, bit 2 red, bit 3 intensity,
+	// and the same for background in bit 4-7
+	inline void AppendColor(std::wstring& out, uint16_t attribute)
+	{
+		auto ansi_color = [](unsigned bits, int base)
+			{
+				int code = (bits & 0b0100 ? 1 : 0) | (bits & 0b0010 ? 2 : 0) | (bits & 0b0001 ? 4 : 0);
+				return (bits & 0b1000 ? base + 60 : base) + code;
+			};
+		out += L"\x1b[";
+		AppendNumber(out, ansi_color(attribute & 0x0F, 30));
+		out += L';';
+		AppendNumber(out, ansi_color(attribute >> 4 & 0x0F, 40));
+		out += L'm';
+	}
+
+	inline void AppendCursorVisible(std::wstring& out, bool visible)
+	{
+		out += visible ? L"\x1b[?25h" : L"\x1b[?25l";
+	}
+
+	inline void AppendTitle(std::wstring& out, std::wstring_view title)
+	{
+		out += L"\x1b]2;";
+		out += title;
+		out += L'\x07';
+	}
+
+	inline void AppendResize(std::wstring& out, short columns, short rows)
+	{
+		out += L"\x1b[8;";
+		AppendNumber(out, rows);
+		out += L';';
+		AppendNumber(out, columns);
+		out += L't';
+	}
+
+	inline void AppendClear(std::wstring& out)
+	{
+		out += L"\x1b[2J\x1b[3J\x1b[H";
+	}
+} // namespace VirtualTerminal
+
+#endif // SNAKE_VIRTUALTERMINAL_HEADER_
\ No newline at end of file
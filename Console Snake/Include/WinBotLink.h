@@ -0,0 +1,49 @@
+﻿#pragma once
+#ifndef SNAKE_WINBOTLINK_HEADER_
+#define SNAKE_WINBOTLINK_HEADER_
+
+#include "BotLink.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "WinHeader.h"
+
+// BotLink over anonymous pipes to a child process, Windows only.
+// Anonymous pipes can't wait with a timeout, so a thread reads them and another writes them.
+class WinBotLink :public BotLink
+{
+public:
+	// run the command line with its standard input and output connected to the link
+	static std::unique_ptr<WinBotLink> Spawn(std::wstring command_line);
+	~WinBotLink() noexcept;
+
+public:
+	void send(std::string_view data, std::chrono::steady_clock::time_point deadline) override;
+	bool receive(std::string& buffer, std::chrono::steady_clock::time_point deadline) override;
+
+private:
+	WinBotLink(HANDLE process, HANDLE to_bot, HANDLE from_bot);
+	void readBot() noexcept;
+	void writeBot() noexcept;
+
+private:
+	HANDLE process;
+	HANDLE to_bot;
+	HANDLE from_bot;
+	std::mutex received_mutex;
+	std::condition_variable received_signal;
+	std::string received; // guarded by received_mutex
+	bool closed = false; // guarded by received_mutex
+	std::mutex sending_mutex;
+	std::condition_variable sending_signal;
+	std::string sending; // guarded by sending_mutex, written by the writer
+	bool writing = false; // guarded by sending_mutex
+	bool write_failed = false; // guarded by sending_mutex
+	bool stopping = false; // guarded by sending_mutex
+	std::thread reader;
+	std::thread writer;
+};
+
+#endif // SNAKE_WINBOTLINK_HEADER_
\ No newline at end of file
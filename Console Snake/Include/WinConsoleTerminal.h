@@ -0,0 +1,36 @@
+﻿#pragma once
+#ifndef SNAKE_WINCONSOLETERMINAL_HEADER_
+#define SNAKE_WINCONSOLETERMINAL_HEADER_
+
+#include "Terminal.h"
+#include "WinHeader.h"
+#include <string>
+#include <optional>
+#include <cstdint>
+
+// Windows console. With VT processing enabled, color and cursor changes are
+// buffered as VT sequences and written in one go on flush(), otherwise they
+// call the console API right away and only the text between them is buffered.
+class WinConsoleTerminal :public Terminal
+{
+public:
+	WinConsoleTerminal(HANDLE output_handle, bool virtual_terminal) noexcept;
+
+public:
+	void setColor(uint16_t attribute) override;
+	void setCursor(short column, short row) override;
+	void write(std::wstring_view str) override;
+	void setCursorVisible(bool visible) override;
+	void setTitle(std::wstring_view title) override;
+	void resize(short columns, short rows) override;
+	void clear() override;
+	void flush() override;
+
+private:
+	HANDLE output_handle;
+	bool virtual_terminal;
+	std::wstring buffer;
+	std::optional<uint16_t> current_color;
+};
+
+#endif // SNAKE_WINCONSOLETERMINAL_HEADER_
\ No newline at end of file
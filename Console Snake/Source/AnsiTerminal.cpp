@@ -0,0 +1,127 @@
+﻿#include "AnsiTerminal.h"
+#include "VirtualTerminal.h"
+#include "Exception.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <unistd.h>
+
+namespace
+{
+	void AppendUTF8(std::string& out, std::wstring_view str)
+	{
+		for (wchar_t ch : str)
+		{
+			auto code = static_cast<uint32_t>(ch);
+			if (code < 0x80)
+			{
+				out += static_cast<char>(code);
+			}
+			else if (code < 0x800)
+			{
+				out += static_cast<char>(0xC0 | (code >> 6));
+				out += static_cast<char>(0x80 | (code & 0x3F));
+			}
+			else if (code < 0x10000)
+			{
+				out += static_cast<char>(0xE0 | (code >> 12));
+				out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+				out += static_cast<char>(0x80 | (code & 0x3F));
+			}
+			else
+			{
+				out += static_cast<char>(0xF0 | (code >> 18));
+				out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+				out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+				out += static_cast<char>(0x80 | (code & 0x3F));
+			}
+		}
+	}
+} // namespace
+
+AnsiTerminal::AnsiTerminal(int output_fd) noexcept
+	: output_fd(output_fd)
+{
+
+}
+
+AnsiTerminal::AnsiTerminal(std::string& output) noexcept
+	: output_fd(-1), output(&output)
+{
+
+}
+
+AnsiTerminal::~AnsiTerminal() noexcept
+{
+	try {
+		flush();
+	}
+	catch (...) {}
+}
+
+void AnsiTerminal::setColor(uint16_t attribute)
+{
+	if (current_color == attribute)
+		return;
+	VirtualTerminal::AppendColor(buffer, attribute);
+	current_color = attribute;
+}
+
+void AnsiTerminal::setCursor(short column, short row)
+{
+	VirtualTerminal::AppendCursor(buffer, column, row);
+}
+
+void AnsiTerminal::write(std::wstring_view str)
+{
+	buffer += str;
+}
+
+void AnsiTerminal::setCursorVisible(bool visible)
+{
+	VirtualTerminal::AppendCursorVisible(buffer, visible);
+}
+
+void AnsiTerminal::setTitle(std::wstring_view title)
+{
+	VirtualTerminal::AppendTitle(buffer, title);
+}
+
+void AnsiTerminal::resize(short columns, short rows)
+{
+	VirtualTerminal::AppendResize(buffer, columns, rows);
+	clear();
+}
+
+void AnsiTerminal::clear()
+{
+	VirtualTerminal::AppendClear(buffer);
+}
+
+void AnsiTerminal::flush()
+{
+	if (buffer.empty())
+		return;
+	if (output)
+	{
+		AppendUTF8(*output, buffer);
+		buffer.clear();
+		return;
+	}
+	encoded.clear();
+	AppendUTF8(encoded, buffer);
+	buffer.clear();
+
+	size_t offset = 0;
+	while (offset < encoded.size())
+	{
+		auto written = ::write(output_fd, encoded.data() + offset, encoded.size() - offset);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			throw RuntimeException(L"Write to terminal failed.");
+		}
+		offset += static_cast<size_t>(written);
+	}
+}
\ No newline at end of file
@@ -7,17 +7,27 @@
 #include "ErrorHandling.h"
 #include "LocalizedStrings.h"
 #include "EncryptedString.h"
-#include "Pythonic.h"
 #include "GlobalData.h"
 
 #include "WinHeader.h"
 #include <clocale>
 #include <cstdlib>
 #include <string>
+#include <chrono>
 
 namespace {
 	bool no_limit = false;
 
+	std::wstring Widen(const char* str)
+	{
+		int length = MultiByteToWideChar(CP_ACP, 0, str, -1, nullptr, 0);
+		if (length <= 1)
+			return {};
+		std::wstring wide(length - 1, L'\0');
+		MultiByteToWideChar(CP_ACP, 0, str, -1, wide.data(), length);
+		return wide;
+	}
+
 	void ParseCMDAndSet(int count, char* commands[])
 	{
 		using namespace std;
@@ -25,13 +35,17 @@ namespace {
 			return;
 
 		string cmd;
-		for (auto i : range(1, count))
+		for (int i = 1; i < count; i++)
 		{
 			cmd = commands[i];
 			// Command Options:
 			// -nolimit: freely adjust the width and height of Console
 			// -oldconsole: enable the compatibility of old console host
 			// -awesome: force enable colorful title
+			// -bot <command line>: a bot process plays through its standard input and output
+			// -botdeadline <milliseconds>: time for the bot to reply to each frame
+			// -export <name>: publish the frames to shared memory for viewers
+			// -replay <file>: write the replay of the last game
 			if (cmd == "-nolimit"_crypt)
 			{
 				no_limit = true;
@@ -45,6 +59,22 @@ namespace {
 			{
 				GameData::get().colorful_title = true;
 			}
+			else if (cmd == "-bot"_crypt && i + 1 < count)
+			{
+				GameData::get().bot_command = Widen(commands[++i]);
+			}
+			else if (cmd == "-botdeadline"_crypt && i + 1 < count)
+			{
+				GameData::get().bot_deadline = chrono::milliseconds(strtoul(commands[++i], nullptr, 10));
+			}
+			else if (cmd == "-export"_crypt && i + 1 < count)
+			{
+				GameData::get().export_name = commands[++i];
+			}
+			else if (cmd == "-replay"_crypt && i + 1 < count)
+			{
+				GameData::get().replay_file = commands[++i];
+			}
 		}
 	}
 
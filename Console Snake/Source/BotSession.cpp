@@ -0,0 +1,193 @@
+﻿#include "BotSession.h"
+#include "Exception.h"
+#include "Pythonic.h"
+
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <utility>
+#include <cassert>
+
+namespace
+{
+	void AppendNumber(std::string& line, long long value)
+	{
+		char digits[24];
+		auto end = std::to_chars(std::begin(digits), std::end(digits), value).ptr;
+		line += ' ';
+		line.append(digits, end);
+	}
+
+	void AppendNode(std::string& line, std::optional<PosNode> pos)
+	{
+		AppendNumber(line, pos ? pos->x : -1);
+		AppendNumber(line, pos ? pos->y : -1);
+	}
+
+	char DirectionLetter(Direction direct) noexcept
+	{
+		switch (+direct)
+		{
+			case Direction::Up:
+				return 'U';
+			case Direction::Down:
+				return 'D';
+			case Direction::Left:
+				return 'L';
+			case Direction::Right:
+				return 'R';
+			default:
+				return 'N';
+		}
+	}
+
+	std::optional<Direction> ParseDirection(std::string_view text) noexcept
+	{
+		if (text.size() != 1)
+			return std::nullopt;
+		switch (text[0])
+		{
+			case 'U':
+				return Direction::Up;
+			case 'D':
+				return Direction::Down;
+			case 'L':
+				return Direction::Left;
+			case 'R':
+				return Direction::Right;
+			case 'N':
+				return Direction::None;
+		}
+		return std::nullopt;
+	}
+} // namespace
+
+BotSession::BotSession(std::unique_ptr<BotLink> link, std::chrono::microseconds deadline)
+	: link(std::move(link)), deadline(deadline)
+{
+
+}
+
+void BotSession::start(const Venue& venue)
+{
+	const size_t height = venue.getHeight(), width = venue.getWidth();
+	line = "snake";
+	AppendNumber(line, ProtocolVersion);
+	AppendNumber(line, static_cast<long long>(height));
+	AppendNumber(line, static_cast<long long>(width));
+	AppendNumber(line, deadline.count());
+	line += "\nmap ";
+	for (auto y : range<uint8_t>(height))
+		for (auto x : range<uint8_t>(width))
+			line += venue.getPositionType(x, y) == Element::Barrier ? '#' : '.';
+
+	// the snake lies straight behind the head before the first frame
+	Direction direct = venue.getSnakeDirection();
+	line += "\nstart ";
+	line += DirectionLetter(direct);
+	AppendNode(line, venue.getFoodPosition());
+	AppendNumber(line, static_cast<long long>(venue.getSnakeLength()));
+	PosNode pos = venue.getSnakeHead();
+	for (auto i : range(venue.getSnakeLength()))
+	{
+		if (i > 0)
+			pos = venue.getAdjacentPosition(pos, -direct);
+		AppendNode(line, pos);
+	}
+	frame = 0;
+	sendLine();
+}
+
+Direction BotSession::awaitMove() noexcept
+{
+	if (!connected)
+		return Direction::None;
+	stats.moves++;
+	auto begin = std::chrono::steady_clock::now();
+	// a reply received in time is taken even if the deadline has passed since, e.g. by pausing
+	auto reply = takeReply();
+	try
+	{
+		while (!reply && link->receive(received, sent_time + deadline))
+			reply = takeReply();
+	}
+	catch (const Exception&)
+	{
+		connected = false;
+	}
+	auto wait = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+	stats.total_wait += wait;
+	stats.max_wait = std::max(stats.max_wait, wait);
+	if (!reply)
+	{
+		stats.late++;
+		return Direction::None;
+	}
+	return *reply;
+}
+
+void BotSession::sendFrame(const Venue& venue, PosNodeGroup frame)
+{
+	assert(frame.count != 0);
+	line = "frame";
+	AppendNumber(line, static_cast<long long>(++this->frame));
+	AppendNode(line, frame.head_pos);
+	AppendNode(line, frame.count == 2 ? std::optional(frame.tail_pos) : std::nullopt);
+	AppendNode(line, venue.getFoodPosition());
+	sendLine();
+}
+
+void BotSession::finish(size_t score, bool win)
+{
+	line = "over";
+	AppendNumber(line, static_cast<long long>(score));
+	AppendNumber(line, win);
+	sendLine();
+}
+
+bool BotSession::isConnected() const noexcept
+{
+	return connected;
+}
+
+const BotStats& BotSession::getStats() const noexcept
+{
+	return stats;
+}
+
+void BotSession::sendLine() noexcept
+{
+	if (!connected)
+		return;
+	line += '\n';
+	try
+	{
+		link->send(line, std::chrono::steady_clock::now() + deadline);
+	}
+	catch (const Exception&)
+	{
+		connected = false; // gone or stuck, a bot which can't take the observations can't play
+	}
+	sent_time = std::chrono::steady_clock::now();
+}
+
+std::optional<Direction> BotSession::takeReply() noexcept
+{
+	std::optional<Direction> reply;
+	size_t begin = 0;
+	for (size_t end; !reply && (end = received.find('\n', begin)) != std::string::npos; begin = end + 1)
+	{
+		std::string_view text(received.data() + begin, end - begin);
+		if (!text.empty() && text.back() == '\r')
+			text.remove_suffix(1);
+		size_t reply_frame = 0;
+		auto [number_end, error] = std::from_chars(text.data(), text.data() + text.size(), reply_frame);
+		if (error != std::errc() || number_end == text.data() + text.size() || *number_end != ' ')
+			continue; // malformed
+		if (reply_frame == frame)
+			reply = ParseDirection(text.substr(number_end - text.data() + 1));
+		// replies to earlier frames are late, and the bot never sees later ones
+	}
+	received.erase(0, begin);
+	return reply;
+}
\ No newline at end of file
@@ -1,9 +1,8 @@
 ﻿#include "Canvas.h"
 #include "Console.h"
-#include "ErrorHandling.h"
-#include "EncryptedString.h"
-#include <cstdio>
-#include <cstdlib>
+#include "Terminal.h"
+
+#include <exception>
 
 Canvas::Canvas()
 {
@@ -68,6 +67,44 @@ void Canvas::clear() noexcept
 	applyClientSize(); // use side effect
 }
 
+void Canvas::setBufferSize(short width, short height)
+{
+	frame = FrameBuffer(width, height);
+}
+
+void Canvas::draw(short x, short y, wchar_t glyph, Color color) noexcept
+{
+	frame.draw(x, y, glyph, color.Value());
+}
+
+void Canvas::present()
+{
+	auto& terminal = Console::get().getTerminal();
+	bool presented = false;
+	frame.present(
+		[&](size_t x, size_t y, std::span<const FrameCell> cells)
+		{
+			COORD coord = Cursor(static_cast<short>(x), static_cast<short>(y)) + offset;
+			terminal.setCursor(coord.X, coord.Y);
+			for (size_t begin = 0, end = 0; begin < cells.size(); begin = end)
+			{
+				present_buffer.clear();
+				for (end = begin; end < cells.size() && cells[end].color == cells[begin].color; end++)
+					present_buffer += cells[end].glyph;
+				terminal.setColor(cells[begin].color);
+				terminal.write(present_buffer);
+			}
+			presented = true;
+		});
+	if (!presented)
+		return;
+	// restore the state for the unbuffered drawing
+	COORD coord = cursor + offset;
+	terminal.setColor(color.Value());
+	terminal.setCursor(coord.X, coord.Y);
+	terminal.flush();
+}
+
 ClientSize Canvas::getClientSize() const noexcept
 {
 	return size;
@@ -80,21 +117,27 @@ Color Canvas::getColor() const noexcept
 
 void Canvas::applyColor()
 {
-	if (!SetConsoleTextAttribute(Console::get().output_handle, static_cast<WORD>(color.Value())))
-		throw NativeException{};
+	auto& terminal = Console::get().getTerminal();
+	terminal.setColor(color.Value());
+	terminal.flush();
 }
 
 void Canvas::applyCursor()
 {
-	if (!SetConsoleCursorPosition(Console::get().output_handle, cursor + offset))
-		throw NativeException{};
+	auto& terminal = Console::get().getTerminal();
+	COORD coord = cursor + offset;
+	terminal.setCursor(coord.X, coord.Y);
+	terminal.flush();
 }
 
 void Canvas::applyClientSize() noexcept
 {
-	char con[32];
-	sprintf_s(con, "mode con: cols=%d lines=%d"_crypt.c_str(), size.width * 2, size.height);
-	system(con); // side effect: clear screen
+	// the width of character is about half of the height
+	try {
+		Console::get().getTerminal().resize(size.width * 2, size.height); // side effect: clear screen
+	}
+	catch (const std::exception&) {} // out of memory for the sequences, the screen stays as it is
+	frame.invalidate();
 }
 
 short Canvas::calCenteredCoord(const std::wstring_view& str) const noexcept
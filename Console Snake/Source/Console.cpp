@@ -1,6 +1,7 @@
 ﻿#include "Console.h"
 #include "ErrorHandling.h"
 #include "WideIO.h"
+#include "WinConsoleTerminal.h"
 #include "LocalizedStrings.h"
 #include "WinHeader.h"
 #include <utility>
@@ -12,6 +13,8 @@ ConsoleBase::ConsoleBase() try
 {
 	output_handle.value = fetchOutputHandle();
 	console_handle.value = fetchConsoleHandle();
+	virtual_terminal.value = enableVirtualTerminal();
+	terminal = std::make_unique<WinConsoleTerminal>(output_handle.value, virtual_terminal.value);
 	// set initial window style
 	setWindowAttribute(WS_VISIBLE | WS_CAPTION | WS_SYSMENU |
 					   WS_MINIMIZEBOX | WS_MAXIMIZEBOX | WS_SIZEBOX);
@@ -23,8 +26,7 @@ catch (const Exception&) {
 
 void ConsoleBase::setTitle(std::wstring new_title)
 {
-	if (!SetConsoleTitleW(new_title.c_str()))
-		throw NativeException{};
+	terminal->setTitle(new_title);
 	title = std::move(new_title);
 }
 
@@ -51,12 +53,7 @@ void ConsoleBase::setConsoleWindow(HasFrame hasframe)
 
 void ConsoleBase::setCursorVisible(bool isVisible)
 {
-	CONSOLE_CURSOR_INFO cci;
-	if (!GetConsoleCursorInfo(output_handle.value, &cci))
-		throw NativeException{};
-	cci.bVisible = static_cast<BOOL>(isVisible);
-	if (!SetConsoleCursorInfo(output_handle.value, &cci))
-		throw NativeException{};
+	terminal->setCursorVisible(isVisible);
 }
 
 void ConsoleBase::moveToScreenCenter() noexcept
@@ -78,6 +75,11 @@ void ConsoleBase::moveToScreenCenter() noexcept
 	MoveWindow(console_handle.value, left, top, width, height, TRUE);
 }
 
+Terminal& ConsoleBase::getTerminal() noexcept
+{
+	return *terminal;
+}
+
 void ConsoleBase::setWindowAttribute(LONG_PTR args)
 {
 	if (!SetWindowLongPtrW(console_handle.value, GWL_STYLE, args))
@@ -108,6 +110,14 @@ HWND ConsoleBase::fetchConsoleHandle() const
 	return hwnd;
 }
 
+bool ConsoleBase::enableVirtualTerminal() const noexcept
+{
+	DWORD mode = 0;
+	if (!GetConsoleMode(output_handle.value, &mode))
+		return false;
+	return SetConsoleMode(output_handle.value, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+}
+
 void ungetwch(wint ch) noexcept
 {
 	static constexpr auto half_bits = sizeof(wint) / 2 * CHAR_BIT;
@@ -1,23 +1,36 @@
 ﻿#include "DemoGround.h"
 #include "WideIO.h"
+#include "FrameScheduler.h"
 
-DemoGround::DemoGround(Canvas& canvas)
-	: canvas(canvas), arena(canvas)
-	, map(arena.getCurrentMap())
+#include <utility>
+#include <conio.h>
+
+DemoGround::DemoGround(Canvas& canvas, std::unique_ptr<Solver> solver)
+	: canvas(canvas), arena(canvas), solver(std::move(solver))
 {
 
 }
 
 void DemoGround::show()
 {
+	FrameScheduler scheduler(FrameInterval);
 	while (!arena.isOver())
 	{
-
-		arena.updateFrame();
+		// a win takes hours on large maps, any key leaves
+		if (_kbhit())
+		{
+			(void)getwch();
+			return;
+		}
+		for (size_t due = scheduler.wait(); due != 0 && !arena.isOver(); due--)
+		{
+			solveNextStep();
+			arena.updateFrame();
+		}
 	}
 }
 
 void DemoGround::solveNextStep()
 {
-
-}
+	arena.pushInput(solver->solveNextStep(arena));
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+﻿#include "FrameBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+
+FrameBuffer::FrameBuffer(size_t width, size_t height)
+	: back(height, width), front(height, width)
+{
+	std::fill(back.iter_all().begin(), back.iter_all().end(), FrameCell{});
+	invalidate();
+}
+
+void FrameBuffer::draw(size_t x, size_t y, wchar_t glyph, uint16_t color) noexcept
+{
+	assert(glyph != 0);
+	back[y][x] = { glyph, color };
+}
+
+void FrameBuffer::invalidate() noexcept
+{
+	std::fill(front.iter_all().begin(), front.iter_all().end(), FrameCell{});
+}
+
+size_t FrameBuffer::width() const noexcept
+{
+	return back.total_size() == 0 ? 0 : back.size(1);
+}
+
+size_t FrameBuffer::height() const noexcept
+{
+	return back.total_size() == 0 ? 0 : back.size(0);
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+﻿#include "FrameExport.h"
+#include "Exception.h"
+
+#include <new>
+#include <thread>
+#include <cstring>
+
+namespace
+{
+	constexpr size_t NodesOffset = (sizeof(SharedFrameHeader) + 63) / 64 * 64;
+} // namespace
+
+FrameExporter::FrameExporter(const std::string& name, const Venue& venue)
+	: memory(SharedMemory::Create(name, NodesOffset + venue.getHeight() * venue.getWidth())),
+	header(new(memory->data().data()) SharedFrameHeader{}),
+	nodes(reinterpret_cast<Element*>(memory->data().data() + NodesOffset))
+{
+	header->version = SharedFrameHeader::Version;
+	header->height = static_cast<uint16_t>(venue.getHeight());
+	header->width = static_cast<uint16_t>(venue.getWidth());
+	header->nodes_offset = static_cast<uint32_t>(NodesOffset);
+	header->snake_length = static_cast<uint32_t>(venue.getSnakeLength());
+	const auto& map = venue.getCurrentMap();
+	for (size_t i = 0; i < map.total_size(); i++)
+		nodes[i] = map.data()[i].type;
+	// no reader maps the segment before the magic
+	header->magic.store(SharedFrameHeader::Magic, std::memory_order_release);
+}
+
+FrameExporter::~FrameExporter() noexcept
+{
+	beginWrite();
+	header->closed = true;
+	endWrite();
+}
+
+void FrameExporter::publish(const Venue& venue, PosNodeGroup frame, size_t score, bool win) noexcept
+{
+	beginWrite();
+	header->frame++;
+	header->score = score;
+	header->snake_length = static_cast<uint32_t>(venue.getSnakeLength());
+	if (frame.count == 0)
+	{
+		header->over = true;
+		header->win = win;
+	}
+	else
+	{
+		writeNode(frame.head_pos, Element::Snake);
+		if (frame.count == 2)
+			writeNode(frame.tail_pos, Element::Blank);
+		else if (auto next = venue.getFoodPosition()) // the eaten one is snake already
+			writeNode(next.value(), Element::Food);
+	}
+	endWrite();
+}
+
+void FrameExporter::beginWrite() noexcept
+{
+	header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	// the odd sequence is visible before any change
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+void FrameExporter::endWrite() noexcept
+{
+	header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void FrameExporter::writeNode(PosNode pos, Element which) noexcept
+{
+	nodes[static_cast<size_t>(pos.y) * header->width + pos.x] = which;
+}
+
+FrameReader::FrameReader(const std::string& name)
+	: memory(SharedMemory::Open(name)),
+	header(reinterpret_cast<const SharedFrameHeader*>(memory->data().data())),
+	nodes(nullptr)
+{
+	auto bytes = memory->data();
+	if (bytes.size() < sizeof(SharedFrameHeader)
+		|| header->magic.load(std::memory_order_acquire) != SharedFrameHeader::Magic
+		|| header->version != SharedFrameHeader::Version
+		|| bytes.size() < header->nodes_offset + size_t{ header->height } * header->width)
+		throw RuntimeException(L"Not a frame export.");
+	nodes = reinterpret_cast<const Element*>(bytes.data() + header->nodes_offset);
+}
+
+size_t FrameReader::getHeight() const noexcept
+{
+	return header->height;
+}
+
+size_t FrameReader::getWidth() const noexcept
+{
+	return header->width;
+}
+
+uint64_t FrameReader::getSequence() const noexcept
+{
+	return header->sequence.load(std::memory_order_acquire);
+}
+
+uint64_t FrameReader::read(SharedFrame& out) const
+{
+	out.nodes.resize(getHeight() * getWidth());
+	for (;;)
+	{
+		uint64_t begin = header->sequence.load(std::memory_order_acquire);
+		if (begin % 2 == 1) // in the middle of a frame, which is a few stores
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		// Copies racing with the writer are thrown away below, what was copied is never used.
+		out.frame = header->frame;
+		out.score = header->score;
+		out.snake_length = header->snake_length;
+		out.over = header->over;
+		out.win = header->win;
+		out.closed = header->closed;
+		std::memcpy(out.nodes.data(), nodes, out.nodes.size());
+		// the copies above are done before the sequence is checked again
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (header->sequence.load(std::memory_order_relaxed) == begin)
+			return begin;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+﻿#include "FrameScheduler.h"
+
+#include <thread>
+#include <algorithm>
+#include <cassert>
+
+FrameScheduler::FrameScheduler(Clock::duration step, size_t max_catch_up) noexcept
+	: step(step), max_catch_up(max_catch_up), deadline(Clock::now())
+{
+	assert(step > Clock::duration::zero());
+	assert(max_catch_up >= 1);
+}
+
+void FrameScheduler::restart() noexcept
+{
+	deadline = Clock::now();
+}
+
+size_t FrameScheduler::wait()
+{
+	std::this_thread::sleep_until(deadline);
+	auto overshoot = Clock::now() - deadline;
+	stats.max_overshoot = std::max(stats.max_overshoot, overshoot);
+
+	size_t due = 1 + static_cast<size_t>(overshoot / step);
+	if (due > 1)
+		stats.late_frames++;
+	if (due > max_catch_up)
+	{
+		// give up the frames missed, keep the phase of deadlines
+		stats.dropped_frames += due - max_catch_up;
+		deadline += step * (due - max_catch_up);
+		due = max_catch_up;
+	}
+	deadline += step * due;
+	stats.ticks += due;
+	return due;
+}
+
+FrameStats FrameScheduler::getStats() const noexcept
+{
+	return stats;
+}
+
+FrameScheduler::Clock::duration FrameScheduler::getStep() const noexcept
+{
+	return step;
+}
\ No newline at end of file
@@ -0,0 +1,203 @@
+﻿#include "GameSession.h"
+
+#include <utility>
+#include <algorithm>
+
+namespace
+{
+	const wchar_t* StatusText(GameSession::Status status) noexcept
+	{
+		switch (status)
+		{
+			case GameSession::Status::Opening: return L"arrows or WASD to start, Q to quit";
+			case GameSession::Status::Pausing: return L"paused, space to go on";
+			case GameSession::Status::Over: return L"game over, R to play again, Q to quit";
+			default: return L"";
+		}
+	}
+} // namespace
+
+GameSession::GameSession(SessionSettings settings, uint64_t seed)
+	: settings(std::move(settings)), seed(seed), venue(this->settings.map, seed),
+	frame(venue.getWidth() * 2, venue.getHeight()), terminal(output)
+{
+	terminal.setCursorVisible(false);
+	restart();
+}
+
+void GameSession::receive(std::span<const char> bytes)
+{
+	for (char key : bytes)
+	{
+		// arrows: ESC [ A-D, or ESC O A-D in application mode
+		if (escape_state == 1)
+		{
+			escape_state = key == '[' || key == 'O' ? 2 : 0;
+			continue;
+		}
+		if (escape_state == 2)
+		{
+			escape_state = 0;
+			switch (key)
+			{
+				case 'A': onKey('w'); break;
+				case 'D': onKey('a'); break;
+				case 'C': onKey('d'); break;
+				case 'B': onKey('s'); break;
+			}
+			continue;
+		}
+		if (key == '\x1b')
+			escape_state = 1;
+		else
+			onKey(key);
+	}
+}
+
+bool GameSession::isDue(Clock::time_point now) const noexcept
+{
+	return dirty || (status == Status::Running && now >= next_frame);
+}
+
+void GameSession::tick(Clock::time_point now)
+{
+	if (status == Status::Running && now >= next_frame)
+	{
+		PosNodeGroup nodes_updated = venue.step(popLegalInput());
+		switch (nodes_updated.count)
+		{
+			case 0: // dead
+				status = Status::Over;
+				break;
+			case 1: // food
+				DrawElementCell(frame, nodes_updated.head_pos.x, nodes_updated.head_pos.y, Element::Snake);
+				if (auto food = venue.getFoodPosition())
+					DrawElementCell(frame, food->x, food->y, Element::Food);
+				break;
+			case 2: // move normally
+				DrawElementCell(frame, nodes_updated.head_pos.x, nodes_updated.head_pos.y, Element::Snake);
+				DrawElementCell(frame, nodes_updated.tail_pos.x, nodes_updated.tail_pos.y, Element::Blank);
+				break;
+		}
+		// a frame missed is given up, as the game does after catching up
+		next_frame = std::max(next_frame + getFrameInterval(), now);
+		dirty = true;
+	}
+	// a client reading slowly gets fewer frames, not more output
+	if (dirty && output.empty())
+		render();
+}
+
+std::string& GameSession::getOutput() noexcept
+{
+	return output;
+}
+
+GameSession::Status GameSession::getStatus() const noexcept
+{
+	return status;
+}
+
+size_t GameSession::getScore() const noexcept
+{
+	return venue.getScore();
+}
+
+void GameSession::onKey(char key)
+{
+	if (status == Status::Closing)
+		return;
+	Direction direction = Direction::None;
+	switch (key)
+	{
+		case 'w': case 'W': direction = Direction::Up; break;
+		case 'a': case 'A': direction = Direction::Left; break;
+		case 'd': case 'D': direction = Direction::Right; break;
+		case 's': case 'S': direction = Direction::Down; break;
+		case ' ':
+			if (status == Status::Running)
+				status = Status::Pausing;
+			else if (status == Status::Pausing)
+				status = Status::Running, next_frame = Clock::now();
+			break;
+		case '+': case '-':
+			settings.speed = std::clamp(settings.speed + (key == '+' ? 1 : -1), 1, 10);
+			break;
+		case 'r': case 'R':
+			if (status == Status::Over)
+				restart();
+			break;
+		case 'q': case 'Q': case '\x03':
+			status = Status::Closing;
+			terminal.setColor(0x07);
+			terminal.setCursor(0, static_cast<short>(venue.getHeight() + 1));
+			terminal.setCursorVisible(true);
+			terminal.flush();
+			return;
+	}
+	if (direction != Direction::None && (status == Status::Opening || status == Status::Running))
+	{
+		if (status == Status::Opening)
+			next_frame = Clock::now();
+		status = Status::Running;
+		if (input_queue.size() < InputQueueCapacity)
+			input_queue.push_back(direction);
+	}
+	dirty = true;
+}
+
+void GameSession::restart()
+{
+	if (status == Status::Over)
+		venue = HeadlessVenue(settings.map, ++seed);
+	input_queue.clear();
+	status = Status::Opening;
+	terminal.clear();
+	frame.invalidate();
+	for (size_t y = 0; y < venue.getHeight(); y++)
+		for (size_t x = 0; x < venue.getWidth(); x++)
+			DrawElementCell(frame, x, y, venue.getPositionType(static_cast<uint8_t>(x), static_cast<uint8_t>(y)));
+	dirty = true;
+}
+
+void GameSession::render()
+{
+	frame.present(
+		[&](size_t x, size_t y, std::span<const FrameCell> cells)
+		{
+			terminal.setCursor(static_cast<short>(x), static_cast<short>(y));
+			for (auto& cell : cells)
+			{
+				terminal.setColor(cell.color);
+				terminal.write(std::wstring_view(&cell.glyph, 1));
+			}
+		});
+	terminal.setColor(0x07);
+	terminal.setCursor(0, static_cast<short>(venue.getHeight()));
+	text = L"score " + std::to_wstring(venue.getScore()) + L"  speed " + std::to_wstring(settings.speed) + L"  ";
+	text += StatusText(status);
+	text += L"\x1b[K"; // erase the rest of the line
+	terminal.write(text);
+	terminal.flush();
+	dirty = false;
+}
+
+Direction GameSession::popLegalInput() noexcept
+{
+	// apply one turn per frame, keep the later ones for the next frames
+	auto current = venue.getSnakeDirection();
+	while (!input_queue.empty())
+	{
+		Direction direction = input_queue.front();
+		input_queue.pop_front();
+		if (direction != current && !direction.isConflictWith(current))
+			return direction;
+	}
+	return Direction::None;
+}
+
+GameSession::Clock::duration GameSession::getFrameInterval() const noexcept
+{
+	using namespace std::chrono_literals;
+	return 30ms + 20ms * (10 - settings.speed); // 30ms - 210ms, level 1-10
+}
\ No newline at end of file
@@ -0,0 +1,444 @@
+﻿#include "HamiltonSolver.h"
+#include "BinaryIO.h"
+#include "Pythonic.h"
+
+#include <chrono>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <cstdio>
+#include <cassert>
+
+namespace
+{
+	constexpr Direction::Tags Candidates[] =
+	{ Direction::Up, Direction::Left, Direction::Right, Direction::Down };
+	constexpr char CycleMagic[4] = { 'S', 'N', 'K', 'C' };
+	constexpr uint16_t CycleVersion = 1;
+	// shortcuts keep this many nodes between the head and the tail
+	constexpr size_t ShortcutMargin = 3;
+	// calls of HamiltonSolver::canJoinCycle per simulated lap
+	constexpr size_t LapCheckInterval = 16;
+
+	bool IsFree(const DynArray<MapNode, 2>& map, size_t x, size_t y) noexcept
+	{
+		return map[y][x].type != Element::Barrier;
+	}
+
+	// adjacent as the snake moves, through the borders
+	bool IsAdjacent(PosNode a, PosNode b, size_t height, size_t width) noexcept
+	{
+		size_t dx = (b.x + width - a.x) % width;
+		size_t dy = (b.y + height - a.y) % height;
+		return (dy == 0 && (dx == 1 || dx == width - 1)) ||
+			(dx == 0 && (dy == 1 || dy == height - 1));
+	}
+
+	// check the path and index it
+	std::optional<HamiltonCycle> MakeCycle(const DynArray<MapNode, 2>& map, std::vector<PosNode> path)
+	{
+		HamiltonCycle cycle{ .height = map.size(0), .width = map.size(1), .path = {}, .order = {} };
+		size_t free_count = std::count_if(map.iter_all().begin(), map.iter_all().end(),
+										  [](const MapNode& node) { return node.type != Element::Barrier; });
+		if (path.size() != free_count || path.size() < 4)
+			return {};
+		cycle.order.assign(map.total_size(), HamiltonCycle::NoOrder);
+		for (auto i : range(path.size()))
+		{
+			auto pos = path[i];
+			auto next = path[(i + 1) % path.size()];
+			if (pos.y >= cycle.height || pos.x >= cycle.width || !IsFree(map, pos.x, pos.y) ||
+				cycle.orderOf(pos) != HamiltonCycle::NoOrder ||
+				!IsAdjacent(pos, next, cycle.height, cycle.width))
+				return {};
+			cycle.order[pos.y * cycle.width + pos.x] = static_cast<uint32_t>(i);
+		}
+		cycle.path = std::move(path);
+		return cycle;
+	}
+
+	// Zigzag through the columns 1..width-1 row by row, then return along column 0.
+	// Closes without borders if the height is even, or through the borders on a whole map.
+	std::vector<PosNode> MakeZigzag(size_t height, size_t width, auto at)
+	{
+		std::vector<PosNode> path;
+		for (auto row : range(height))
+		{
+			for (auto i : range<size_t>(1, width))
+				path.push_back(at(row, row % 2 == 0 ? i : width - i));
+		}
+		for (auto row : range(height))
+			path.push_back(at(height - 1 - row, size_t{ 0 }));
+		return path;
+	}
+
+	std::optional<HamiltonCycle> FindRectangleCycle(const DynArray<MapNode, 2>& map)
+	{
+		size_t left = map.size(1), right = 0, top = map.size(0), bottom = 0, free_count = 0;
+		for (auto y : range(map.size(0)))
+			for (auto x : range(map.size(1)))
+				if (IsFree(map, x, y))
+				{
+					left = std::min(left, x), right = std::max(right, x);
+					top = std::min(top, y), bottom = std::max(bottom, y);
+					free_count++;
+				}
+		if (free_count == 0)
+			return {};
+		size_t height = bottom - top + 1, width = right - left + 1;
+		if (free_count != height * width || height < 2 || width < 2)
+			return {};
+
+		auto by_row = [&](size_t row, size_t column)
+			{
+				return PosNode{ static_cast<uint8_t>(left + column), static_cast<uint8_t>(top + row) };
+			};
+		auto by_column = [&](size_t column, size_t row) { return by_row(row, column); };
+		if (auto cycle = MakeCycle(map, MakeZigzag(height, width, by_row)))
+			return cycle;
+		return MakeCycle(map, MakeZigzag(width, height, by_column));
+	}
+
+	// Depth-first search preferring the nodes with the fewest ways out (Warnsdorff's rule).
+	std::optional<HamiltonCycle> SearchCycle(const DynArray<MapNode, 2>& map, size_t search_budget)
+	{
+		const size_t height = map.size(0), width = map.size(1);
+		std::vector<PosNode> nodes;
+		std::vector<uint32_t> index_of(map.total_size(), HamiltonCycle::NoOrder);
+		for (auto y : range(height))
+			for (auto x : range(width))
+				if (IsFree(map, x, y))
+				{
+					index_of[y * width + x] = static_cast<uint32_t>(nodes.size());
+					nodes.push_back({ static_cast<uint8_t>(x), static_cast<uint8_t>(y) });
+				}
+		const size_t count = nodes.size();
+		if (count < 4)
+			return {};
+
+		std::vector<std::vector<uint32_t>> adjacent(count);
+		for (auto i : range(count))
+		{
+			auto [x, y] = nodes[i];
+			PosNode around[] = {
+				{ x, static_cast<uint8_t>((y + height - 1) % height) },
+				{ static_cast<uint8_t>((x + width - 1) % width), y },
+				{ static_cast<uint8_t>((x + 1) % width), y },
+				{ x, static_cast<uint8_t>((y + 1) % height) },
+			};
+			for (auto pos : around)
+			{
+				auto j = index_of[pos.y * width + pos.x];
+				if (j != HamiltonCycle::NoOrder && j != i &&
+					std::find(adjacent[i].begin(), adjacent[i].end(), j) == adjacent[i].end())
+					adjacent[i].push_back(j);
+			}
+			if (adjacent[i].size() < 2)
+				return {};
+		}
+
+		// a bipartite graph has no cycle through all nodes if its parts differ in size
+		std::vector<int8_t> color(count, -1);
+		bool bipartite = true;
+		std::vector<uint32_t> queue{ 0 };
+		color[0] = 0;
+		for (size_t head = 0; head < queue.size(); head++)
+			for (auto j : adjacent[queue[head]])
+			{
+				if (color[j] == -1)
+				{
+					color[j] = !color[queue[head]];
+					queue.push_back(j);
+				}
+				else if (color[j] == color[queue[head]])
+					bipartite = false;
+			}
+		if (queue.size() != count)
+			return {}; // not connected
+		if (bipartite && std::count(color.begin(), color.end(), 0) * 2 != static_cast<ptrdiff_t>(count))
+			return {};
+
+		std::vector<bool> visited(count, false);
+		auto exits = [&](uint32_t i)
+			{
+				return std::count_if(adjacent[i].begin(), adjacent[i].end(),
+									 [&](uint32_t j) { return !visited[j]; });
+			};
+		struct Frame
+		{
+			uint32_t node;
+			uint32_t candidates[4];
+			uint8_t candidate_count;
+			uint8_t next_candidate;
+		};
+		std::vector<Frame> stack;
+		auto push = [&](uint32_t node)
+			{
+				visited[node] = true;
+				Frame frame{ .node = node, .candidates = {}, .candidate_count = 0, .next_candidate = 0 };
+				for (auto j : adjacent[node])
+					if (!visited[j])
+						frame.candidates[frame.candidate_count++] = j;
+				// insertion sort of at most four, std::sort trips -Warray-bounds on them
+				for (uint8_t i = 1; i < frame.candidate_count; i++)
+					for (uint8_t j = i; j > 0 && exits(frame.candidates[j]) < exits(frame.candidates[j - 1]); j--)
+						std::swap(frame.candidates[j], frame.candidates[j - 1]);
+				stack.push_back(frame);
+			};
+
+		push(0);
+		while (!stack.empty() && search_budget-- > 0)
+		{
+			auto& frame = stack.back();
+			if (stack.size() == count)
+			{
+				auto& first = adjacent[0];
+				if (std::find(first.begin(), first.end(), frame.node) != first.end())
+				{
+					std::vector<PosNode> path;
+					for (auto& step : stack)
+						path.push_back(nodes[step.node]);
+					return MakeCycle(map, std::move(path));
+				}
+			}
+			if (frame.next_candidate == frame.candidate_count)
+			{
+				visited[frame.node] = false;
+				stack.pop_back();
+				continue;
+			}
+			auto next = frame.candidates[frame.next_candidate++];
+			if (!visited[next])
+				push(next);
+		}
+		return {};
+	}
+
+	// Venue that steps without generating food, for simulations of the solver
+	class VenueProbe :public Venue
+	{
+	public:
+		explicit VenueProbe(const Venue& venue) :Venue(venue) {}
+		PosNodeGroup step(Direction direct) noexcept
+		{
+			orderDirection(direct);
+			return updateFrame();
+		}
+	};
+
+	Direction DirectionTo(const Venue& venue, PosNode from, PosNode to) noexcept
+	{
+		for (Direction direct : Candidates)
+		{
+			auto pos = venue.getAdjacentPosition(from, direct);
+			if (pos.x == to.x && pos.y == to.y)
+				return direct;
+		}
+		return Direction::None;
+	}
+} // namespace
+
+uint64_t HashMapShape(const DynArray<MapNode, 2>& map) noexcept
+{
+	// FNV-1a
+	uint64_t hash = 0xCBF29CE484222325;
+	auto mix = [&](uint64_t value)
+		{
+			hash ^= value;
+			hash *= 0x100000001B3;
+		};
+	mix(map.size(0));
+	mix(map.size(1));
+	for (auto& node : map.iter_all())
+		mix(node.type == Element::Barrier);
+	return hash;
+}
+
+std::optional<HamiltonCycle> FindHamiltonCycle(const DynArray<MapNode, 2>& map, size_t search_budget)
+{
+	if (auto cycle = FindRectangleCycle(map))
+		return cycle;
+	return SearchCycle(map, search_budget);
+}
+
+CycleCache::CycleCache(std::optional<std::filesystem::path> directory)
+	: directory(std::move(directory))
+{
+
+}
+
+CycleCache& CycleCache::Shared()
+{
+	static CycleCache cache(std::filesystem::path{});
+	return cache;
+}
+
+CycleCache::CycleFuture CycleCache::request(const DynArray<MapNode, 2>& map)
+{
+	uint64_t hash = HashMapShape(map);
+	std::lock_guard lock(mutex);
+	auto& cycle = cycles[hash];
+	if (!cycle.valid())
+	{
+		cycle = std::async(std::launch::async,
+						   [this, map, hash] { return loadOrFind(map, hash); });
+	}
+	return cycle;
+}
+
+std::optional<HamiltonCycle> CycleCache::loadOrFind(const DynArray<MapNode, 2>& map, uint64_t hash) const
+{
+	if (directory)
+	{
+		std::ifstream file(pathOf(hash), std::ios::binary);
+		char magic[sizeof(CycleMagic)] = {};
+		file.read(magic, sizeof(magic));
+		if (file && std::equal(std::begin(magic), std::end(magic), std::begin(CycleMagic)) &&
+			ReadInteger<uint16_t>(file) == CycleVersion && ReadInteger<uint64_t>(file) == hash)
+		{
+			std::vector<PosNode> path(ReadInteger<uint32_t>(file) % (map.total_size() + 1));
+			for (auto& pos : path)
+			{
+				pos.x = static_cast<uint8_t>(file.get());
+				pos.y = static_cast<uint8_t>(file.get());
+			}
+			if (file)
+			{
+				if (auto cycle = MakeCycle(map, std::move(path)))
+					return cycle; // otherwise the file is broken, find it again
+			}
+		}
+	}
+
+	auto cycle = FindHamiltonCycle(map, SearchBudget);
+	if (cycle && directory)
+	{
+		std::ofstream file(pathOf(hash), std::ios::binary);
+		file.write(CycleMagic, sizeof(CycleMagic));
+		WriteInteger(file, CycleVersion);
+		WriteInteger(file, hash);
+		WriteInteger(file, static_cast<uint32_t>(cycle->path.size()));
+		for (auto pos : cycle->path)
+		{
+			file.put(static_cast<char>(pos.x));
+			file.put(static_cast<char>(pos.y));
+		}
+	}
+	return cycle;
+}
+
+std::filesystem::path CycleCache::pathOf(uint64_t hash) const
+{
+	char name[64];
+	std::snprintf(name, sizeof(name), "SnakeCycle-%016llx.bin", static_cast<unsigned long long>(hash));
+	return *directory / name;
+}
+
+HamiltonSolver::HamiltonSolver(CycleCache& cache)
+	: cache(cache)
+{
+
+}
+
+Direction HamiltonSolver::solveNextStep(const Venue& venue)
+{
+	using namespace std::chrono_literals;
+	if (!cycle_future.valid())
+		cycle_future = cache.request(venue.getCurrentMap());
+	if (!cycle && cycle_future.wait_for(0s) == std::future_status::ready && cycle_future.get())
+		cycle = &*cycle_future.get();
+
+	// the body is made of the last heads, so it lies along the cycle after enough moves in order
+	const auto head = venue.getSnakeHead();
+	if (cycle)
+	{
+		bool in_order = last_head && cycle->path[(cycle->orderOf(*last_head) + 1) % cycle->path.size()] == head;
+		steps_in_order = in_order ? steps_in_order + 1 : 0;
+	}
+	last_head = head;
+
+	if (cycle && !on_cycle && canJoinCycle(venue))
+	{
+		on_cycle = true;
+		steps_on_cycle = 0;
+	}
+	if (on_cycle)
+	{
+		if (auto direct = followCycle(venue); direct != Direction::None)
+			return direct;
+		on_cycle = false; // should not happen, let the fallback try
+	}
+	return fallback.solveNextStep(venue);
+}
+
+std::wstring_view HamiltonSolver::name() const noexcept
+{
+	return L"Hamilton";
+}
+
+bool HamiltonSolver::canJoinCycle(const Venue& venue)
+{
+	// the nodes ahead on the cycle are free up to the tail
+	if (steps_in_order + 1 >= venue.getSnakeLength())
+		return true;
+	if (++calls_since_lap < LapCheckInterval)
+		return false;
+	calls_since_lap = 0;
+
+	const size_t count = cycle->path.size();
+	VenueProbe probe(venue);
+	for (size_t lap = 0; lap < count && probe.getSnakeLength() < count; lap++)
+	{
+		auto head = probe.getSnakeHead();
+		auto next = cycle->path[(cycle->orderOf(head) + 1) % count];
+		auto direct = DirectionTo(probe, head, next);
+		if (direct == Direction::None || direct.isConflictWith(probe.getSnakeDirection()))
+			return false;
+		if (probe.step(direct).count == 0)
+			return false;
+	}
+	return true;
+}
+
+Direction HamiltonSolver::followCycle(const Venue& venue)
+{
+	const size_t count = cycle->path.size();
+	const size_t length = venue.getSnakeLength();
+	const auto head = venue.getSnakeHead();
+	const auto head_order = cycle->orderOf(head);
+	const size_t free_ahead = cycle->distance(head_order, cycle->orderOf(venue.getSnakeTail()));
+	auto target = cycle->path[(head_order + 1) % count];
+
+	// shortcut towards the food, only once the body lies along the cycle
+	auto food = venue.getFoodPosition();
+	if (food && steps_on_cycle >= length && length * 2 < count)
+	{
+		size_t food_distance = cycle->distance(head_order, cycle->orderOf(*food));
+		size_t best_distance = 1;
+		for (Direction direct : Candidates)
+		{
+			if (direct.isConflictWith(venue.getSnakeDirection()))
+				continue;
+			auto pos = venue.getAdjacentPosition(head, direct);
+			auto type = venue.getPositionType(pos.x, pos.y);
+			if (type == Element::Barrier || type == Element::Snake)
+				continue;
+			size_t distance = cycle->distance(head_order, cycle->orderOf(pos));
+			if (distance > best_distance && distance <= food_distance &&
+				distance + ShortcutMargin < free_ahead)
+			{
+				best_distance = distance;
+				target = pos;
+			}
+		}
+	}
+	steps_on_cycle++;
+
+	auto direct = DirectionTo(venue, head, target);
+	auto type = venue.getPositionType(target.x, target.y);
+	if (direct.isConflictWith(venue.getSnakeDirection()) ||
+		type == Element::Barrier || type == Element::Snake)
+		return Direction::None;
+	return direct;
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+﻿#include "HeadlessVenue.h"
+
+#include <utility>
+#include <cstring>
+#include <cassert>
+
+template<CellStorage Storage>
+BasicHeadlessVenue<Storage>::BasicHeadlessVenue(DynArray<MapNode, 2> map)
+	: Base(std::move(map))
+{
+
+}
+
+template<CellStorage Storage>
+BasicHeadlessVenue<Storage>::BasicHeadlessVenue(DynArray<MapNode, 2> map, uint64_t seed)
+	: Base(std::move(map), seed)
+{
+
+}
+
+template<CellStorage Storage>
+PosNodeGroup BasicHeadlessVenue<Storage>::step(Direction input)
+{
+	assert(!game_over);
+	this->orderDirection(input);
+	PosNodeGroup nodes_updated = Base::updateFrame();
+	ticks++;
+	switch (nodes_updated.count)
+	{
+		case 0: // dead
+			game_over = true;
+			break;
+		case 1: // food
+			this->generateFood();
+			score++;
+			break;
+	}
+	return nodes_updated;
+}
+
+template<CellStorage Storage>
+size_t BasicHeadlessVenue<Storage>::stepN(std::span<const Direction> inputs)
+{
+	size_t consumed = 0;
+	for (auto input : inputs)
+	{
+		if (game_over)
+			break;
+		step(input);
+		consumed++;
+	}
+	return consumed;
+}
+
+template<CellStorage Storage>
+bool BasicHeadlessVenue<Storage>::isOver() const noexcept
+{
+	return game_over;
+}
+
+template<CellStorage Storage>
+bool BasicHeadlessVenue<Storage>::isWin() const noexcept
+{
+	return Base::isWin(score);
+}
+
+template<CellStorage Storage>
+size_t BasicHeadlessVenue<Storage>::getScore() const noexcept
+{
+	return score;
+}
+
+template<CellStorage Storage>
+size_t BasicHeadlessVenue<Storage>::getTicks() const noexcept
+{
+	return ticks;
+}
+
+template<CellStorage Storage>
+size_t BasicHeadlessVenue<Storage>::getSnapshotSize() const noexcept
+{
+	return Base::getSnapshotSize() + sizeof(Progress);
+}
+
+template<CellStorage Storage>
+void BasicHeadlessVenue<Storage>::snapshot(std::span<std::byte> buffer) const noexcept
+{
+	assert(buffer.size() == getSnapshotSize());
+	auto venue_part = buffer.first(Base::getSnapshotSize());
+	Base::snapshot(venue_part);
+	Progress progress{ score, ticks, game_over };
+	std::memcpy(buffer.data() + venue_part.size(), &progress, sizeof(progress));
+}
+
+template<CellStorage Storage>
+void BasicHeadlessVenue<Storage>::restore(std::span<const std::byte> buffer) noexcept
+{
+	assert(buffer.size() == getSnapshotSize());
+	auto venue_part = buffer.first(Base::getSnapshotSize());
+	Base::restore(venue_part);
+	Progress progress;
+	std::memcpy(&progress, buffer.data() + venue_part.size(), sizeof(progress));
+	score = progress.score;
+	ticks = progress.ticks;
+	game_over = progress.game_over;
+}
+
+template class BasicHeadlessVenue<PackedCells>;
+template class BasicHeadlessVenue<CellPlanes>;
+template class BasicHeadlessVenue<FixedCells<15, 15>>;
+template class BasicHeadlessVenue<FixedCells<20, 20>>;
+template class BasicHeadlessVenue<FixedCells<24, 24>>;
\ No newline at end of file
@@ -0,0 +1,313 @@
+﻿#include "MultiSnakeVenue.h"
+#include "Exception.h"
+#include "Pythonic.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	constexpr Direction::Tags Candidates[] =
+	{ Direction::Up, Direction::Left, Direction::Right, Direction::Down };
+	// tries of random placement before giving up
+	constexpr size_t PlacementTries = 32;
+} // namespace
+
+MultiSnakeVenue::MultiSnakeVenue(const DynArray<MapNode, 2>& map, size_t food_count, uint64_t seed)
+	: cells(map.size(0), map.size(1)), food_target(food_count), random_engine(seed),
+	claims(map.size(0), map.size(1))
+{
+	// PosNode holds coordinates up to 255
+	if (map.size(0) < 2 || map.size(1) < 2 || map.size(0) > UINT8_MAX || map.size(1) > UINT8_MAX)
+		throw RuntimeException(L"Invalid Map.");
+	std::transform(map.iter_all().begin(), map.iter_all().end(), cells.iter_all().begin(),
+				   [](const MapNode& node)
+				   {
+					   Cell cell;
+					   cell.type = node.type == Element::Barrier ? Element::Barrier : Element::Blank;
+					   return cell;
+				   });
+	blank_count = std::count_if(cells.iter_all().begin(), cells.iter_all().end(),
+								[](const Cell& cell) { return cell.type == Element::Blank; });
+	refillFood();
+}
+
+std::optional<uint32_t> MultiSnakeVenue::spawnSnake(size_t length)
+{
+	assert(length > 0);
+	if (length >= std::min(getHeight(), getWidth()))
+		return {}; // would overlap itself through the borders
+	for ([[maybe_unused]] auto attempt : range(PlacementTries))
+	{
+		PosNode head{
+			random_engine.between<uint8_t>(0, static_cast<uint8_t>(getWidth() - 1)),
+			random_engine.between<uint8_t>(0, static_cast<uint8_t>(getHeight() - 1)),
+		};
+		Direction direct = Candidates[random_engine.bounded(4)];
+
+		// the body lies behind the head
+		bool has_room = true;
+		PosNode pos = head;
+		for (auto i : range(length))
+		{
+			if (i > 0)
+				pos = getAdjacentPosition(pos, -direct);
+			if (cellAt(pos).type != Element::Blank)
+			{
+				has_room = false;
+				break;
+			}
+		}
+		if (!has_room)
+			continue;
+
+		uint32_t id;
+		if (!free_ids.empty())
+		{
+			id = free_ids.back();
+			free_ids.pop_back();
+		}
+		else
+		{
+			id = static_cast<uint32_t>(snakes.size());
+			snakes.emplace_back();
+			targets.emplace_back();
+			dying.push_back(false);
+		}
+		snakes[id] = Snake{
+			.head = head, .tail = pos, .direct = direct, .ordered = direct,
+			.length = static_cast<uint32_t>(length), .alive = true,
+		};
+		pos = head;
+		for (auto i : range(length))
+		{
+			if (i > 0)
+				pos = getAdjacentPosition(pos, -direct);
+			cellAt(pos) = Cell{ .type = Element::Snake, .owner = id, .toward_head = direct };
+		}
+		blank_count -= length;
+		alive_count++;
+		return id;
+	}
+	return {};
+}
+
+void MultiSnakeVenue::orderDirection(uint32_t snake, Direction direct) noexcept
+{
+	assert(snake < snakes.size());
+	snakes[snake].ordered = direct;
+}
+
+MultiSnakeVenue::TickResult MultiSnakeVenue::tick()
+{
+	ticks++;
+	TickResult result{ .deaths = 0, .meals = 0 };
+
+	// choose the moves and claim the next nodes
+	for (auto id : range(snakes.size()))
+	{
+		auto& snake = snakes[id];
+		if (!snake.alive)
+			continue;
+		if (snake.ordered != Direction::None && !snake.ordered.isConflictWith(snake.direct))
+			snake.direct = snake.ordered;
+		auto target = getAdjacentPosition(snake.head, snake.direct);
+		targets[id] = target;
+
+		auto type = cellAt(target).type;
+		dying[id] = type == Element::Barrier || (type == Element::Snake && !isLeftThisTick(target));
+		if (dying[id])
+			continue;
+		auto& claim = claims[target.y][target.x];
+		if (claim.tick != ticks)
+			claim = Claim{ .tick = ticks, .length = snake.length, .winner = static_cast<uint32_t>(id) };
+		else if (snake.length > claim.length)
+			claim.length = snake.length, claim.winner = static_cast<uint32_t>(id);
+		else if (snake.length == claim.length)
+			claim.winner = NoSnake;
+	}
+	for (auto id : range(snakes.size()))
+	{
+		if (snakes[id].alive && !dying[id])
+			dying[id] = claims[targets[id].y][targets[id].x].winner != id || isSwappingHeads(id);
+	}
+
+	// clear the dead first, their tails are left as well
+	for (auto id : range(snakes.size()))
+	{
+		auto& snake = snakes[id];
+		if (!snake.alive || !dying[id])
+			continue;
+		removeBody(snake);
+		snake.alive = false;
+		free_ids.push_back(static_cast<uint32_t>(id));
+		alive_count--;
+		result.deaths++;
+	}
+	// then the tails, so that the heads could take them
+	for (auto& snake : snakes)
+	{
+		if (!snake.alive)
+			continue;
+		cellAt(snake.head).toward_head = snake.direct;
+		if (snake.growth > 0)
+		{
+			snake.growth--;
+			snake.length++;
+			continue;
+		}
+		auto& tail = cellAt(snake.tail);
+		auto next = getAdjacentPosition(snake.tail, tail.toward_head);
+		tail = Cell{};
+		snake.tail = next;
+		blank_count++;
+	}
+	// then the heads
+	for (auto id : range(snakes.size()))
+	{
+		auto& snake = snakes[id];
+		if (!snake.alive)
+			continue;
+		auto& cell = cellAt(targets[id]);
+		if (cell.type == Element::Food)
+		{
+			snake.score++;
+			snake.growth++;
+			food_count--;
+			result.meals++;
+		}
+		else
+			blank_count--;
+		cell = Cell{ .type = Element::Snake, .owner = static_cast<uint32_t>(id), .toward_head = Direction::None };
+		snake.head = targets[id];
+	}
+	refillFood();
+	return result;
+}
+
+PosNode MultiSnakeVenue::getAdjacentPosition(PosNode pos, Direction direct) const noexcept
+{
+	uint8_t height = static_cast<uint8_t>(getHeight());
+	uint8_t width = static_cast<uint8_t>(getWidth());
+	switch (+direct)
+	{
+		case Direction::Up:
+			pos.y == 0 ? pos.y = height - 1 : pos.y--;
+			break;
+		case Direction::Down:
+			pos.y == height - 1 ? pos.y = 0 : pos.y++;
+			break;
+		case Direction::Left:
+			pos.x == 0 ? pos.x = width - 1 : pos.x--;
+			break;
+		case Direction::Right:
+			pos.x == width - 1 ? pos.x = 0 : pos.x++;
+			break;
+		default:
+			break;
+	}
+	return pos;
+}
+
+const MultiSnakeVenue::Cell& MultiSnakeVenue::getCell(PosNode pos) const noexcept
+{
+	return cells[pos.y][pos.x];
+}
+
+const MultiSnakeVenue::Snake& MultiSnakeVenue::getSnake(uint32_t snake) const noexcept
+{
+	assert(snake < snakes.size());
+	return snakes[snake];
+}
+
+size_t MultiSnakeVenue::getSnakeCount() const noexcept
+{
+	return snakes.size();
+}
+
+size_t MultiSnakeVenue::getAliveCount() const noexcept
+{
+	return alive_count;
+}
+
+size_t MultiSnakeVenue::getFoodCount() const noexcept
+{
+	return food_count;
+}
+
+size_t MultiSnakeVenue::getTicks() const noexcept
+{
+	return ticks;
+}
+
+size_t MultiSnakeVenue::getHeight() const noexcept
+{
+	return cells.size(0);
+}
+
+size_t MultiSnakeVenue::getWidth() const noexcept
+{
+	return cells.size(1);
+}
+
+MultiSnakeVenue::Cell& MultiSnakeVenue::cellAt(PosNode pos) noexcept
+{
+	return cells[pos.y][pos.x];
+}
+
+std::optional<PosNode> MultiSnakeVenue::findBlank()
+{
+	if (blank_count == 0)
+		return {};
+	for ([[maybe_unused]] auto attempt : range(PlacementTries))
+	{
+		PosNode pos{
+			random_engine.between<uint8_t>(0, static_cast<uint8_t>(getWidth() - 1)),
+			random_engine.between<uint8_t>(0, static_cast<uint8_t>(getHeight() - 1)),
+		};
+		if (cellAt(pos).type == Element::Blank)
+			return pos;
+	}
+	return {}; // crowded, try in the next tick
+}
+
+void MultiSnakeVenue::refillFood()
+{
+	while (food_count < food_target)
+	{
+		auto pos = findBlank();
+		if (!pos)
+			break;
+		cellAt(*pos).type = Element::Food;
+		food_count++;
+		blank_count--;
+	}
+}
+
+void MultiSnakeVenue::removeBody(const Snake& snake) noexcept
+{
+	PosNode pos = snake.tail;
+	for (auto i : range(snake.length))
+	{
+		auto& cell = cellAt(pos);
+		if (i + 1 < snake.length)
+			pos = getAdjacentPosition(pos, cell.toward_head);
+		cell = Cell{};
+	}
+	blank_count += snake.length;
+}
+
+bool MultiSnakeVenue::isSwappingHeads(size_t id) const noexcept
+{
+	const auto& cell = getCell(targets[id]);
+	if (cell.type != Element::Snake || cell.owner == id)
+		return false;
+	const auto& other = snakes[cell.owner];
+	return other.head == targets[id] && targets[cell.owner] == snakes[id].head;
+}
+
+bool MultiSnakeVenue::isLeftThisTick(PosNode pos) const noexcept
+{
+	const auto& owner = snakes[getCell(pos).owner];
+	return owner.growth == 0 && owner.tail.x == pos.x && owner.tail.y == pos.y;
+}
\ No newline at end of file
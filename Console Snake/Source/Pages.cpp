@@ -1047,7 +1047,7 @@ void BeginPage::run()
 	paintInterface();
 
 	(void)getwch();
-	*is_press = true;
+	title_timer.reset(); // wait for the painting in progress
 	GameData::get().selection = PageSelect::MenuPage;
 	SoundPlayer::get().play(Sounds::Intro);
 }
@@ -1059,35 +1059,33 @@ void BeginPage::paintInterface()
 	canvas.setCursorCentered(~Token::press_any_key, baseY / 2 + 4);
 	print(~Token::press_any_key);
 
-	std::thread th_paint(
-		[this, is_press = is_press]
-		{
-			using namespace std::chrono_literals;
-			if (GameData::get().colorful_title)
-				for (Color color;;)
-				{
-					if (*is_press)
-						return;
-					canvas.setCursor(0, 0);
-					canvas.setColor(color.setNextValue());
-					print(Resource::GameTitle);
-					print(~Token::game_version);
-					std::this_thread::sleep_for(200ms);
-				}
-			else
-				for (bool color_flag = false;;)
-				{
-					if (*is_press)
-						return;
-					canvas.setCursor(0, 0);
-					canvas.setColor(color_flag ? Color::Aqua : Color::LightBlue);
-					print(Resource::GameTitle);
-					print(~Token::game_version);
-					color_flag = !color_flag;
-					std::this_thread::sleep_for(900ms);
-				}
-		});
-	th_paint.detach();
+	using namespace std::chrono_literals;
+	if (GameData::get().colorful_title)
+	{
+		Color color;
+		repaintTitle(color.setNextValue());
+		title_timer.emplace([this, color]() mutable
+							{
+								repaintTitle(color.setNextValue());
+							}, 200ms, Timer::Loop);
+	}
+	else
+	{
+		repaintTitle(Color::LightBlue);
+		title_timer.emplace([this, color_flag = true]() mutable
+							{
+								repaintTitle(color_flag ? Color::Aqua : Color::LightBlue);
+								color_flag = !color_flag;
+							}, 900ms, Timer::Loop);
+	}
+}
+
+void BeginPage::repaintTitle(Color color)
+{
+	canvas.setCursor(0, 0);
+	canvas.setColor(color);
+	print(Resource::GameTitle);
+	print(~Token::game_version);
 }
 
 /***************************************
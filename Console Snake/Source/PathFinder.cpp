@@ -0,0 +1,246 @@
+﻿#include "PathFinder.h"
+#include "Pythonic.h"
+
+#include <algorithm>
+#include <functional>
+#include <cassert>
+
+namespace
+{
+	constexpr Direction::Tags Candidates[] =
+	{ Direction::Up, Direction::Left, Direction::Right, Direction::Down };
+
+	// shortest distance on a ring
+	uint32_t RingDistance(size_t a, size_t b, size_t size) noexcept
+	{
+		size_t forward = a < b ? b - a : a - b;
+		return static_cast<uint32_t>(std::min(forward, size - forward));
+	}
+} // namespace
+
+PathFinder::PathFinder(const DynArray<MapNode, 2>& map)
+{
+	prepare(map);
+}
+
+void PathFinder::prepare(const DynArray<MapNode, 2>& map)
+{
+	if (map.size(0) == height && map.size(1) == width)
+		return;
+	height = map.size(0);
+	width = map.size(1);
+	const size_t count = height * width;
+
+	adjacent.resize(count);
+	for (auto y : range(height))
+		for (auto x : range(width))
+		{
+			adjacent[y * width + x] = {
+				static_cast<uint32_t>((y == 0 ? height - 1 : y - 1) * width + x),
+				static_cast<uint32_t>(y * width + (x == 0 ? width - 1 : x - 1)),
+				static_cast<uint32_t>(y * width + (x == width - 1 ? 0 : x + 1)),
+				static_cast<uint32_t>((y == height - 1 ? 0 : y + 1) * width + x),
+			};
+		}
+	stamps.assign(count, 0);
+	stamp = 0;
+	distances.resize(count);
+	parents.resize(count);
+	frontier.resize(count);
+	// every relaxation pushes once, plus the source
+	open_list.clear();
+	open_list.reserve(count * 4 + 1);
+	path.clear();
+	path.reserve(count);
+}
+
+void PathFinder::measureFrom(const Venue& venue, PosNode source)
+{
+	bind(venue);
+	nextStamp();
+	breadthFirst(indexOf(source));
+}
+
+uint32_t PathFinder::getDistance(PosNode pos) const noexcept
+{
+	auto index = indexOf(pos);
+	return stamps[index] == stamp ? distances[index] : Unreachable;
+}
+
+std::span<const Direction> PathFinder::findPath(const Venue& venue, PosNode from, PosNode to)
+{
+	bind(venue);
+	nextStamp();
+	path.clear();
+	const uint32_t source = indexOf(from), target = indexOf(to);
+	if (source == target || !isPassable(target))
+		return {};
+
+	// the distance through the borders never overestimates
+	auto estimate = [&](uint32_t index)
+		{
+			return RingDistance(index / width, to.y, height) + RingDistance(index % width, to.x, width);
+		};
+	auto push = [&](uint32_t index, uint32_t distance)
+		{
+			open_list.push_back(uint64_t{ distance + estimate(index) } << 32 | index);
+			std::push_heap(open_list.begin(), open_list.end(), std::greater{});
+		};
+	open_list.clear();
+	stamps[source] = stamp;
+	distances[source] = 0;
+	push(source, 0);
+	while (!open_list.empty())
+	{
+		std::pop_heap(open_list.begin(), open_list.end(), std::greater{});
+		auto index = static_cast<uint32_t>(open_list.back());
+		auto priority = static_cast<uint32_t>(open_list.back() >> 32);
+		open_list.pop_back();
+		if (priority != distances[index] + estimate(index))
+			continue; // outdated, the node was reached by a shorter way later
+		if (index == target)
+			break;
+		for (auto next : adjacent[index])
+		{
+			auto distance = distances[index] + 1;
+			if (!isPassable(next) || (stamps[next] == stamp && distances[next] <= distance))
+				continue;
+			stamps[next] = stamp;
+			distances[next] = distance;
+			parents[next] = index;
+			push(next, distance);
+		}
+	}
+	if (stamps[target] != stamp)
+		return {};
+
+	for (auto index = target; index != source; index = parents[index])
+	{
+		auto parent = parents[index];
+		auto& around = adjacent[parent];
+		auto direct = std::find(std::begin(around), std::end(around), index) - std::begin(around);
+		path.push_back(Candidates[direct]);
+	}
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+
+size_t PathFinder::countReachable(const Venue& venue, PosNode from)
+{
+	bind(venue);
+	nextStamp();
+	auto source = indexOf(from);
+	return isPassable(source) ? flood(source, 0) : 0;
+}
+
+PathFinder::MoveSurvey PathFinder::surveyMoves(const Venue& venue)
+{
+	bind(venue);
+	MoveSurvey survey;
+	const auto head = indexOf(venue.getSnakeHead());
+	for (auto i : range(survey.size()))
+	{
+		survey[i].direct = Candidates[i];
+		survey[i].legal = !survey[i].direct.isConflictWith(venue.getSnakeDirection()) &&
+			isPassable(adjacent[head][i]);
+	}
+
+	if (auto food = venue.getFoodPosition())
+	{
+		nextStamp();
+		breadthFirst(indexOf(*food));
+		for (auto i : range(survey.size()))
+		{
+			auto next = adjacent[head][i];
+			if (survey[i].legal && stamps[next] == stamp)
+				survey[i].food_distance = distances[next];
+		}
+	}
+
+	// moves into the same area share one flood, distinguished by labels in parents
+	nextStamp();
+	size_t area_sizes[4] = {};
+	for (auto i : range(survey.size()))
+	{
+		auto next = adjacent[head][i];
+		if (!survey[i].legal)
+			continue;
+		if (stamps[next] != stamp)
+			area_sizes[i] = flood(next, static_cast<uint32_t>(i));
+		survey[i].reachable = area_sizes[parents[next]];
+	}
+	return survey;
+}
+
+uint32_t PathFinder::indexOf(PosNode pos) const noexcept
+{
+	assert(pos.y < height && pos.x < width);
+	return static_cast<uint32_t>(pos.y * width + pos.x);
+}
+
+bool PathFinder::isPassable(uint32_t index) const noexcept
+{
+	auto type = nodes[index].type;
+	return type == Element::Blank || type == Element::Food;
+}
+
+void PathFinder::nextStamp() noexcept
+{
+	if (++stamp == 0)
+	{
+		// wrapped around after 2^32 queries, forget the ancient stamps
+		std::fill(stamps.begin(), stamps.end(), 0);
+		stamp = 1;
+	}
+}
+
+void PathFinder::bind(const Venue& venue)
+{
+	const auto& map = venue.getCurrentMap();
+	prepare(map);
+	nodes = map.data();
+}
+
+void PathFinder::breadthFirst(uint32_t source)
+{
+	// the frontier is walked while growing, no node enters it twice
+	size_t begin = 0, end = 0;
+	stamps[source] = stamp;
+	distances[source] = 0;
+	frontier[end++] = source;
+	while (begin < end)
+	{
+		auto index = frontier[begin++];
+		for (auto next : adjacent[index])
+		{
+			if (stamps[next] == stamp || !isPassable(next))
+				continue;
+			stamps[next] = stamp;
+			distances[next] = distances[index] + 1;
+			frontier[end++] = next;
+		}
+	}
+}
+
+size_t PathFinder::flood(uint32_t source, uint32_t label)
+{
+	size_t end = 0;
+	stamps[source] = stamp;
+	parents[source] = label;
+	frontier[end++] = source;
+	size_t count = 0;
+	while (end > 0)
+	{
+		auto index = frontier[--end];
+		count++;
+		for (auto next : adjacent[index])
+		{
+			if (stamps[next] == stamp || !isPassable(next))
+				continue;
+			stamps[next] = stamp;
+			parents[next] = label;
+			frontier[end++] = next;
+		}
+	}
+	return count;
+}
\ No newline at end of file
@@ -9,18 +9,45 @@
 #include "KeyMap.h"
 #include "GlobalData.h"
 #include "ScopeGuard.h"
+#include "ErrorHandling.h"
+#include "WinBotLink.h"
 
 #include <thread>
 #include <atomic>
 #include <chrono>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <cwctype>
+#include <fstream>
 #include "WinHeader.h"
 
-PlayGround::PlayGround(Canvas& canvas) :canvas(canvas), arena(canvas)
+namespace
+{
+	std::chrono::milliseconds GetFrameInterval() noexcept
+	{
+		using namespace std::chrono_literals;
+		return 30ms + 20ms * (10 - GameSetting::get().speed.Value()); // 30ms - 210ms, level 1-10
+	}
+}
+
+PlayGround::PlayGround(Canvas& canvas)
+	:canvas(canvas), arena(canvas), frame_scheduler(GetFrameInterval())
 {
 	GameData::get().score = 0;
+	if (auto& command = GameData::get().bot_command; !command.empty())
+	{
+		auto deadline = GameData::get().bot_deadline;
+		bot = std::make_unique<BotSession>(WinBotLink::Spawn(command),
+										   deadline.count() != 0 ? deadline : GetFrameInterval());
+		arena.attachBot(*bot);
+	}
+	if (auto& name = GameData::get().export_name; !name.empty())
+	{
+		exporter = std::make_unique<FrameExporter>(name, arena);
+		arena.attachExporter(*exporter);
+	}
 	if (GameSetting::get().opening_pause)
 	{
 		game_status = GameStatus::Pausing;
@@ -30,8 +57,6 @@ PlayGround::PlayGround(Canvas& canvas) :canvas(canvas), arena(canvas)
 
 void PlayGround::play()
 {
-	using namespace std::chrono_literals;
-
 	std::thread th_input(
 		[this]
 		{
@@ -39,26 +64,24 @@ void PlayGround::play()
 			{
 				if (arena.isOver())
 					return (void)getwch();
-				if (arena.input_key != Direction::None)
-					continue;
 				auto ch = getwch();
 				if (game_status == GameStatus::Running)
 					switch (ch)
 					{
 						case K_UP: case K_W: case K_w:
-							arena.input_key = +Direction::Up;
+							arena.pushInput(Direction::Up);
 							break;
 
 						case K_DOWN: case K_S: case K_s:
-							arena.input_key = +Direction::Down;
+							arena.pushInput(Direction::Down);
 							break;
 
 						case K_LEFT: case K_A: case K_a:
-							arena.input_key = +Direction::Left;
+							arena.pushInput(Direction::Left);
 							break;
 
 						case K_RIGHT: case K_D: case K_d:
-							arena.input_key = +Direction::Right;
+							arena.pushInput(Direction::Right);
 							break;
 					}
 				switch (ch)
@@ -67,12 +90,12 @@ void PlayGround::play()
 						if (game_status == GameStatus::Pausing)
 						{
 							opening_flag = false;
-							game_status = GameStatus::Running;
+							changeStatus(GameStatus::Running);
 							Console::get().setTitle(~Token::title_gaming);
 						}
 						else
 						{
-							game_status = GameStatus::Pausing;
+							changeStatus(GameStatus::Pausing);
 							Console::get().setTitle(~Token::title_pausing);
 							SoundPlayer::get().play(Sounds::Cancel);
 						}
@@ -82,13 +105,13 @@ void PlayGround::play()
 						if (opening_flag && game_status == GameStatus::Pausing)
 						{
 							opening_flag = false;
-							game_status = GameStatus::Running;
+							changeStatus(GameStatus::Running);
 							Console::get().setTitle(~Token::title_gaming);
 						}
 						break;
 
 					case K_Esc:
-						game_status = GameStatus::Ending;
+						changeStatus(GameStatus::Ending);
 						return;
 				}
 			}
@@ -102,50 +125,95 @@ void PlayGround::play()
 		while (!th_input.joinable()); // synchronization
 	};
 
-	std::atomic<bool> pause_flicker_flag = false;
+	bool pause_flicker_flag = false; // guarded by event_mutex
+	std::optional<bool> painted_flicker_flag; // what the next position shows now
 	Timer timer([&]
 				{
-					pause_flicker_flag = !pause_flicker_flag;
+					{
+						std::lock_guard lock(event_mutex);
+						pause_flicker_flag = !pause_flicker_flag;
+					}
+					event_signal.notify_one();
 				}, PauseFlickerInterval, Timer::Loop);
+	auto paint_next_position = [&](bool flicker)
+	{
+		auto [x, y] = arena.getNextPosition();
+		if (flicker)
+			arena.paintElement(Element::Snake, x, y);
+		else
+			arena.paintElement(arena.getPositionType(x, y), x, y);
+		painted_flicker_flag = flicker;
+	};
 
+	frame_scheduler.restart();
 	while (true)
 	{
 		switch (game_status)
 		{
 			case GameStatus::Running:
 			{
-				arena.updateFrame();
-				if (arena.isOver())
+				if (painted_flicker_flag.value_or(false))
+					paint_next_position(false); // erase the flicker left by pausing
+				painted_flicker_flag.reset();
+				for (size_t due = frame_scheduler.wait(); due != 0; due--)
 				{
-					exit_th_input();
-					ending();
-					return;
-				}
-				else
-				{
-					std::this_thread::sleep_for(30ms + // 30ms - 210ms, level 1-10
-												20ms * (10 - GameSetting::get().speed.Value()));
+					arena.updateFrame();
+					if (arena.isOver())
+					{
+						exit_th_input();
+						saveReplay();
+						ending();
+						return;
+					}
+					if (game_status != GameStatus::Running)
+						break;
 				}
 			}
 			break;
 
 			case GameStatus::Pausing:
 			{
-				auto [x, y] = arena.getNextPosition();
-				if (pause_flicker_flag)
-					arena.paintElement(Element::Snake, x, y);
-				else
-					arena.paintElement(arena.getPositionType(x, y), x, y);
-				std::this_thread::sleep_for(1us);
+				std::unique_lock lock(event_mutex);
+				event_signal.wait(lock, [&] {
+					return game_status != GameStatus::Pausing || pause_flicker_flag != painted_flicker_flag;
+				});
+				bool flicker = pause_flicker_flag;
+				lock.unlock();
+				if (game_status == GameStatus::Pausing)
+					paint_next_position(flicker);
+				frame_scheduler.restart(); // don't catch up the paused time
 			}
 			break;
 
 			case GameStatus::Ending:
+				saveReplay();
 				return;
 		}
 	}
 }
 
+void PlayGround::changeStatus(GameStatus status)
+{
+	{
+		std::lock_guard lock(event_mutex);
+		game_status = status;
+	}
+	event_signal.notify_one();
+}
+
+void PlayGround::saveReplay() const noexcept
+{
+	auto& file_name = GameData::get().replay_file;
+	if (file_name.empty())
+		return;
+	try {
+		std::ofstream replay_file(file_name, std::ios::binary);
+		arena.getReplay().save(replay_file);
+	}
+	catch (const std::exception&) {} // replays are only for reproducing bugs
+	catch (const Exception&) {}
+}
+
 void PlayGround::ending()
 {
 	auto [baseX, baseY] = canvas.getClientSize();
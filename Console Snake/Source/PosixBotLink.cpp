@@ -0,0 +1,154 @@
+﻿#include "PosixBotLink.h"
+#include "Exception.h"
+
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <cstddef>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+namespace
+{
+#ifdef MSG_NOSIGNAL
+	constexpr int SendFlags = MSG_NOSIGNAL; // a gone bot is an error, not SIGPIPE
+#else
+	constexpr int SendFlags = 0;
+#endif
+	// time for the bot to exit by itself after the end of input
+	constexpr int ExitWaitMilliseconds = 1000;
+	constexpr int ExitPollMilliseconds = 10;
+
+	// Wait until the deadline for the socket to be ready for the events, rounded up,
+	// so that it never gives up before the deadline. Returns false if it isn't in time.
+	bool PollUntil(int socket_fd, short events, std::chrono::steady_clock::time_point deadline)
+	{
+		while (true)
+		{
+			auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+			pollfd entry{ .fd = socket_fd, .events = events, .revents = 0 };
+			int ready = poll(&entry, 1, static_cast<int>(std::max<long long>(left.count(), 0)));
+			if (ready > 0)
+				return true;
+			if (ready == 0)
+				return false;
+			if (errno != EINTR)
+				throw RuntimeException(L"The bot is gone.");
+		}
+	}
+} // namespace
+
+std::unique_ptr<PosixBotLink> PosixBotLink::Spawn(std::span<char* const> command)
+{
+	if (command.empty())
+		throw RuntimeException(L"No bot command.");
+	std::vector<char*> argv(command.begin(), command.end());
+	argv.push_back(nullptr);
+
+	int sockets[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+		throw RuntimeException(L"Cannot create the socket of the bot.");
+	fcntl(sockets[0], F_SETFD, FD_CLOEXEC);
+	pid_t child = fork();
+	if (child == 0)
+	{
+		dup2(sockets[1], STDIN_FILENO);
+		dup2(sockets[1], STDOUT_FILENO);
+		close(sockets[0]);
+		close(sockets[1]);
+		execvp(argv[0], argv.data());
+		_exit(127);
+	}
+	close(sockets[1]);
+	if (child < 0)
+	{
+		close(sockets[0]);
+		throw RuntimeException(L"Cannot start the bot.");
+	}
+	return std::unique_ptr<PosixBotLink>(new PosixBotLink(sockets[0], child));
+}
+
+std::unique_ptr<PosixBotLink> PosixBotLink::Connect(const std::string& socket_path)
+{
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (socket_path.size() >= sizeof(address.sun_path))
+		throw RuntimeException(L"The socket path of the bot is too long.");
+	std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+	int socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (socket_fd < 0)
+		throw RuntimeException(L"Cannot create the socket of the bot.");
+	fcntl(socket_fd, F_SETFD, FD_CLOEXEC);
+	if (connect(socket_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		close(socket_fd);
+		throw RuntimeException(L"Cannot connect to the bot.");
+	}
+	return std::unique_ptr<PosixBotLink>(new PosixBotLink(socket_fd, 0));
+}
+
+PosixBotLink::PosixBotLink(int socket_fd, pid_t child) noexcept
+	: socket_fd(socket_fd), child(child)
+{
+
+}
+
+PosixBotLink::~PosixBotLink() noexcept
+{
+	close(socket_fd); // the bot reads the end of input
+	if (child > 0)
+	{
+		for (int waited = 0; waited < ExitWaitMilliseconds; waited += ExitPollMilliseconds)
+		{
+			if (waitpid(child, nullptr, WNOHANG) == child)
+				return;
+			usleep(ExitPollMilliseconds * 1000);
+		}
+		kill(child, SIGTERM);
+		while (waitpid(child, nullptr, 0) < 0 && errno == EINTR);
+	}
+}
+
+void PosixBotLink::send(std::string_view data, std::chrono::steady_clock::time_point deadline)
+{
+	while (!data.empty())
+	{
+		// never blocks, a bot which doesn't read fills the socket buffer
+		ssize_t written = ::send(socket_fd, data.data(), data.size(), SendFlags | MSG_DONTWAIT);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				throw RuntimeException(L"The bot is gone.");
+			if (!PollUntil(socket_fd, POLLOUT, deadline))
+				throw RuntimeException(L"The bot doesn't take its input.");
+			continue;
+		}
+		data.remove_prefix(static_cast<size_t>(written));
+	}
+}
+
+bool PosixBotLink::receive(std::string& buffer, std::chrono::steady_clock::time_point deadline)
+{
+	while (true)
+	{
+		if (!PollUntil(socket_fd, POLLIN, deadline))
+			return false;
+		char data[4096];
+		ssize_t count = read(socket_fd, data, sizeof(data));
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count <= 0)
+			throw RuntimeException(L"The bot is gone.");
+		buffer.append(data, static_cast<size_t>(count));
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+﻿#include "SharedMemory.h"
+#include "Exception.h"
+
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+	// shm_open() wants one leading slash
+	std::string SegmentName(const std::string& name)
+	{
+		return name.starts_with('/') ? name : '/' + name;
+	}
+} // namespace
+
+std::unique_ptr<SharedMemory> SharedMemory::Create(const std::string& name, size_t size)
+{
+	std::string segment = SegmentName(name);
+	shm_unlink(segment.c_str());
+	int fd = shm_open(segment.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (fd < 0)
+		throw RuntimeException(L"Cannot create the shared memory.");
+	void* address = MAP_FAILED;
+	if (ftruncate(fd, static_cast<off_t>(size)) == 0) // zero filled
+		address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (address == MAP_FAILED)
+	{
+		close(fd);
+		shm_unlink(segment.c_str());
+		throw RuntimeException(L"Cannot map the shared memory.");
+	}
+	return std::unique_ptr<SharedMemory>(new SharedMemory(std::move(segment), address, size, fd, true));
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Open(const std::string& name)
+{
+	std::string segment = SegmentName(name);
+	int fd = shm_open(segment.c_str(), O_RDONLY, 0);
+	if (fd < 0)
+		throw RuntimeException(L"Cannot open the shared memory.");
+	struct stat status;
+	void* address = MAP_FAILED;
+	if (fstat(fd, &status) == 0 && status.st_size > 0)
+		address = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	if (address == MAP_FAILED)
+	{
+		close(fd);
+		throw RuntimeException(L"Cannot map the shared memory.");
+	}
+	return std::unique_ptr<SharedMemory>(new SharedMemory(std::move(segment), address,
+														  static_cast<size_t>(status.st_size), fd, false));
+}
+
+SharedMemory::SharedMemory(std::string name, void* address, size_t size, intptr_t handle, bool owner) noexcept
+	: name(std::move(name)), address(address), size(size), handle(handle), owner(owner)
+{
+
+}
+
+SharedMemory::~SharedMemory() noexcept
+{
+	munmap(address, size);
+	close(static_cast<int>(handle));
+	if (owner)
+		shm_unlink(name.c_str());
+}
+
+std::span<std::byte> SharedMemory::data() const noexcept
+{
+	return { static_cast<std::byte*>(address), size };
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+﻿#include "Replay.h"
+#include "Exception.h"
+#include "BinaryIO.h"
+
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+
+/*
+ * Replay file, little-endian:
+ *     char[4]   magic "SNKR"
+ *     uint16    version
+ *     uint64    seed
+ *     uint16    height, width
+ *     uint8[]   map element types, 2 bits each, 4 nodes per byte
+ *     uint32    count of runs
+ *     runs      uint8 direction, then the count as a LEB128 varint
+ */
+
+namespace
+{
+	constexpr char ReplayMagic[4] = { 'S', 'N', 'K', 'R' };
+	// bumped whenever the same seed and inputs play differently
+	constexpr uint16_t ReplayVersion = 2;
+
+	void WriteVarint(std::ostream& out, uint32_t value)
+	{
+		do {
+			uint8_t byte = value & 0x7F;
+			value >>= 7;
+			out.put(static_cast<char>(value ? byte | 0x80 : byte));
+		} while (value);
+	}
+
+	uint32_t ReadVarint(std::istream& in)
+	{
+		uint32_t value = 0;
+		for (int shift = 0; shift < 35; shift += 7)
+		{
+			auto byte = static_cast<uint8_t>(in.get());
+			value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return value;
+		}
+		throw RuntimeException(L"Invalid replay.");
+	}
+} // namespace
+
+size_t Replay::getTicks() const noexcept
+{
+	size_t ticks = 0;
+	for (auto& run : runs)
+		ticks += run.count;
+	return ticks;
+}
+
+size_t Replay::simulate() const
+{
+	return VisitHeadlessVenue(map, seed,
+		[this](auto& venue)
+		{
+			size_t frames = 0;
+			for (auto [direction, count] : runs)
+			{
+				for (uint32_t i = 0; i < count; i++, frames++)
+				{
+					if (venue.isOver())
+						return frames;
+					venue.step(direction);
+				}
+			}
+			return frames;
+		});
+}
+
+void Replay::save(std::ostream& out) const
+{
+	out.write(ReplayMagic, sizeof(ReplayMagic));
+	WriteInteger(out, ReplayVersion);
+	WriteInteger(out, seed);
+	WriteInteger(out, static_cast<uint16_t>(map.size(0)));
+	WriteInteger(out, static_cast<uint16_t>(map.size(1)));
+	uint8_t packed = 0;
+	size_t index = 0;
+	for (auto& node : map.iter_all())
+	{
+		packed |= static_cast<uint8_t>(node.type) << (index % 4 * 2);
+		if (++index % 4 == 0)
+			out.put(static_cast<char>(std::exchange(packed, 0)));
+	}
+	if (index % 4 != 0)
+		out.put(static_cast<char>(packed));
+	WriteInteger(out, static_cast<uint32_t>(runs.size()));
+	for (auto& run : runs)
+	{
+		out.put(static_cast<char>(+run.direction));
+		WriteVarint(out, run.count);
+	}
+	if (!out)
+		throw RuntimeException(L"Failed to write the replay.");
+}
+
+Replay Replay::Load(std::istream& in)
+{
+	char magic[sizeof(ReplayMagic)] = {};
+	in.read(magic, sizeof(magic));
+	if (!std::equal(std::begin(magic), std::end(magic), std::begin(ReplayMagic)) ||
+		ReadInteger<uint16_t>(in) != ReplayVersion)
+		throw RuntimeException(L"Invalid replay.");
+
+	Replay replay;
+	replay.seed = ReadInteger<uint64_t>(in);
+	auto height = ReadInteger<uint16_t>(in);
+	auto width = ReadInteger<uint16_t>(in);
+	if (height == 0 || width == 0 || !in)
+		throw RuntimeException(L"Invalid replay.");
+	replay.map = DynArray<MapNode, 2>(height, width);
+	uint8_t packed = 0;
+	size_t index = 0;
+	for (auto& node : replay.map.iter_all())
+	{
+		if (index % 4 == 0)
+			packed = static_cast<uint8_t>(in.get());
+		node.type = static_cast<Element>(packed >> (index % 4 * 2) & 0x3);
+		index++;
+	}
+	auto run_count = ReadInteger<uint32_t>(in);
+	if (!in)
+		throw RuntimeException(L"Invalid replay.");
+	for (uint32_t i = 0; i < run_count; i++)
+	{
+		auto direction = static_cast<Direction::Tags>(in.get());
+		if (direction > Direction::Down)
+			throw RuntimeException(L"Invalid replay.");
+		replay.runs.push_back({ direction, ReadVarint(in) });
+	}
+	if (!in)
+		throw RuntimeException(L"Invalid replay.");
+	return replay;
+}
+
+ReplayRecorder::ReplayRecorder(DynArray<MapNode, 2> map, uint64_t seed)
+{
+	replay.seed = seed;
+	replay.map = std::move(map);
+}
+
+void ReplayRecorder::record(Direction direction)
+{
+	if (!replay.runs.empty() && replay.runs.back().direction == direction &&
+		replay.runs.back().count != UINT32_MAX)
+		replay.runs.back().count++;
+	else
+		replay.runs.push_back({ direction, 1 });
+}
+
+const Replay& ReplayRecorder::getReplay() const noexcept
+{
+	return replay;
+}
+
+ReplayPlayer::ReplayPlayer(const Replay& replay)
+	: replay(replay), venue(replay.map, replay.seed)
+{
+
+}
+
+bool ReplayPlayer::step()
+{
+	if (isFinished())
+		return false;
+	venue.step(replay.runs[run_index].direction);
+	if (++run_offset == replay.runs[run_index].count)
+	{
+		run_index++;
+		run_offset = 0;
+	}
+	return true;
+}
+
+size_t ReplayPlayer::playToEnd()
+{
+	size_t frames = 0;
+	while (step())
+		frames++;
+	return frames;
+}
+
+bool ReplayPlayer::isFinished() const noexcept
+{
+	return run_index == replay.runs.size() || venue.isOver();
+}
+
+const HeadlessVenue& ReplayPlayer::getVenue() const noexcept
+{
+	return venue;
+}
\ No newline at end of file
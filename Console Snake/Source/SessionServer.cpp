@@ -0,0 +1,386 @@
+﻿#include "SessionServer.h"
+#include "Random.h"
+#include "Pythonic.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <span>
+#include <utility>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace
+{
+	constexpr unsigned char TelnetIAC = 255, TelnetSB = 250, TelnetSE = 240, TelnetWILL = 251;
+	constexpr unsigned char TelnetECHO = 1, TelnetSGA = 3;
+	// the server echoes nothing and suppresses go-ahead: character mode without local echo
+	constexpr char TelnetGreeting[] = {
+		static_cast<char>(TelnetIAC), static_cast<char>(TelnetWILL), static_cast<char>(TelnetECHO),
+		static_cast<char>(TelnetIAC), static_cast<char>(TelnetWILL), static_cast<char>(TelnetSGA),
+	};
+
+	enum struct TelnetState
+	{
+		Data, Command, Option, Subnegotiation, SubnegotiationCommand
+	};
+
+	void AddToEpoll(int epoll_fd, int fd, uint32_t events)
+	{
+		epoll_event event{};
+		event.events = events;
+		event.data.fd = fd;
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+			throw RuntimeException(L"Cannot watch the socket.");
+	}
+} // namespace
+
+struct SessionServer::Connection
+{
+	Connection(int fd, bool telnet, SessionSettings settings)
+		: fd(fd), telnet(telnet), session(std::move(settings), GetRandomSeed())
+	{
+
+	}
+
+	// drop telnet commands from the bytes received, return the count of bytes kept
+	size_t filterTelnet(std::span<char> bytes) noexcept
+	{
+		size_t kept = 0;
+		for (char byte : bytes)
+		{
+			auto code = static_cast<unsigned char>(byte);
+			switch (telnet_state)
+			{
+				case TelnetState::Data:
+					if (code == TelnetIAC)
+						telnet_state = TelnetState::Command;
+					else if (code != 0) // after CR
+						bytes[kept++] = byte;
+					break;
+				case TelnetState::Command:
+					if (code == TelnetIAC) // escaped 255
+						bytes[kept++] = byte, telnet_state = TelnetState::Data;
+					else if (code == TelnetSB)
+						telnet_state = TelnetState::Subnegotiation;
+					else if (code >= TelnetWILL) // WILL, WONT, DO, DONT <option>
+						telnet_state = TelnetState::Option;
+					else
+						telnet_state = TelnetState::Data;
+					break;
+				case TelnetState::Option:
+					telnet_state = TelnetState::Data;
+					break;
+				case TelnetState::Subnegotiation:
+					if (code == TelnetIAC)
+						telnet_state = TelnetState::SubnegotiationCommand;
+					break;
+				case TelnetState::SubnegotiationCommand:
+					telnet_state = code == TelnetSE ? TelnetState::Data : TelnetState::Subnegotiation;
+					break;
+			}
+		}
+		return kept;
+	}
+
+	int fd;
+	bool telnet;
+	TelnetState telnet_state = TelnetState::Data;
+	bool writing = false; // waiting for the socket to be writable
+	GameSession session;
+};
+
+SessionServer::SessionServer(SessionSettings settings, size_t thread_count)
+	: settings(std::move(settings))
+	, thread_count(std::max<size_t>(thread_count != 0 ? thread_count : std::thread::hardware_concurrency(), 1))
+	, start(static_cast<ptrdiff_t>(this->thread_count))
+	, finish(static_cast<ptrdiff_t>(this->thread_count))
+{
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (epoll_fd < 0 || timer_fd < 0 || stop_fd < 0)
+	{
+		for (int fd : { epoll_fd, timer_fd, stop_fd })
+			if (fd >= 0)
+				::close(fd);
+		throw RuntimeException(L"Cannot create the server.");
+	}
+	AddToEpoll(epoll_fd, timer_fd, EPOLLIN);
+	AddToEpoll(epoll_fd, stop_fd, EPOLLIN);
+
+	for (auto thread_index : range<size_t>(1, this->thread_count))
+	{
+		threads.emplace_back([this, thread_index]
+			{
+				while (true)
+				{
+					start.arrive_and_wait();
+					if (stopping)
+						return;
+					tickShare(thread_index);
+					finish.arrive_and_wait();
+				}
+			});
+	}
+}
+
+SessionServer::~SessionServer()
+{
+	stopping = true;
+	start.arrive_and_wait();
+	threads.clear(); // join
+	for (auto& [fd, connection] : connections)
+		::close(fd);
+	for (int fd : listeners)
+		::close(fd);
+	for (auto& path : socket_paths)
+		::unlink(path.c_str());
+	::close(stop_fd);
+	::close(timer_fd);
+	::close(epoll_fd);
+}
+
+void SessionServer::listenUnix(const std::string& path)
+{
+	sockaddr_un address{};
+	if (path.size() >= sizeof(address.sun_path))
+		throw RuntimeException(L"The socket path is too long.");
+	address.sun_family = AF_UNIX;
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		throw RuntimeException(L"Cannot create the socket.");
+	::unlink(path.c_str());
+	if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0)
+	{
+		::close(fd);
+		throw RuntimeException(L"Cannot listen on the socket.");
+	}
+	socket_paths.push_back(path);
+	addListener(fd);
+}
+
+void SessionServer::listenTcp(uint16_t port)
+{
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		throw RuntimeException(L"Cannot create the socket.");
+	int reuse = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+	if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0)
+	{
+		::close(fd);
+		throw RuntimeException(L"Cannot listen on the port.");
+	}
+	addListener(fd);
+}
+
+void SessionServer::run()
+{
+	itimerspec period{};
+	period.it_interval.tv_nsec = std::chrono::nanoseconds(TickInterval).count();
+	period.it_value = period.it_interval;
+	timerfd_settime(timer_fd, 0, &period, nullptr);
+
+	epoll_event events[64];
+	for (bool running = true; running;)
+	{
+		int count = epoll_wait(epoll_fd, events, static_cast<int>(std::size(events)), -1);
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count < 0)
+			throw RuntimeException(L"Cannot wait for the sockets.");
+		for (auto& event : std::span(events, static_cast<size_t>(count)))
+		{
+			int fd = event.data.fd;
+			uint64_t expirations = 0;
+			if (fd == stop_fd)
+				running = false;
+			else if (fd == timer_fd)
+			{
+				// expirations missed are given up, the sessions keep their own deadlines
+				if (read(timer_fd, &expirations, sizeof(expirations)) > 0)
+					tickSessions();
+			}
+			else if (std::find(listeners.begin(), listeners.end(), fd) != listeners.end())
+				accept(fd);
+			else if (auto found = connections.find(fd); found != connections.end())
+			{
+				Connection& connection = *found->second;
+				if (event.events & EPOLLOUT && !send(connection))
+					continue;
+				if (event.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+					receive(connection);
+			}
+		}
+	}
+	uint64_t stops = 0;
+	(void)read(stop_fd, &stops, sizeof(stops));
+	period = {}; // disarm
+	timerfd_settime(timer_fd, 0, &period, nullptr);
+}
+
+void SessionServer::stop() noexcept
+{
+	uint64_t one = 1;
+	(void)::write(stop_fd, &one, sizeof(one)); // async-signal-safe
+}
+
+size_t SessionServer::getSessionCount() const noexcept
+{
+	return connections.size();
+}
+
+size_t SessionServer::getThreadCount() const noexcept
+{
+	return thread_count;
+}
+
+void SessionServer::addListener(int fd)
+{
+	try {
+		AddToEpoll(epoll_fd, fd, EPOLLIN);
+	}
+	catch (...) {
+		::close(fd);
+		throw;
+	}
+	listeners.push_back(fd);
+}
+
+void SessionServer::accept(int listener)
+{
+	while (true)
+	{
+		sockaddr_storage address{};
+		socklen_t length = sizeof(address);
+		int fd = accept4(listener, reinterpret_cast<sockaddr*>(&address), &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0 && errno == EINTR)
+			continue;
+		if (fd < 0) // EAGAIN: all accepted, otherwise the client is gone already
+			return;
+		bool telnet = address.ss_family != AF_UNIX;
+		if (telnet)
+		{
+			int no_delay = 1; // frames are small and must not wait for each other
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+		}
+		try {
+			AddToEpoll(epoll_fd, fd, EPOLLIN | EPOLLRDHUP);
+			auto connection = std::make_unique<Connection>(fd, telnet, settings);
+			if (telnet)
+				connection->session.getOutput().append(TelnetGreeting, std::size(TelnetGreeting));
+			send(*connections.emplace(fd, std::move(connection)).first->second);
+		}
+		catch (const std::exception&) {
+			::close(fd); // the server goes on without the client
+		}
+		catch (const Exception&) {
+			::close(fd);
+		}
+	}
+}
+
+void SessionServer::receive(Connection& connection)
+{
+	char buffer[256];
+	while (true)
+	{
+		auto received = recv(connection.fd, buffer, sizeof(buffer), 0);
+		if (received < 0 && errno == EINTR)
+			continue;
+		if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if (received <= 0)
+			return close(connection);
+		std::span<char> bytes(buffer, static_cast<size_t>(received));
+		connection.session.receive(bytes.first(connection.telnet ? connection.filterTelnet(bytes) : bytes.size()));
+	}
+	if (connection.session.getStatus() == GameSession::Status::Closing)
+		send(connection);
+}
+
+bool SessionServer::send(Connection& connection)
+{
+	auto& output = connection.session.getOutput();
+	size_t sent = 0;
+	while (sent < output.size())
+	{
+		auto written = ::send(connection.fd, output.data() + sent, output.size() - sent, MSG_NOSIGNAL);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if (written < 0)
+			return close(connection), false;
+		sent += static_cast<size_t>(written);
+	}
+	output.erase(0, sent);
+
+	bool pending = !output.empty();
+	if (pending != connection.writing)
+	{
+		epoll_event event{};
+		event.events = EPOLLIN | EPOLLRDHUP | (pending ? uint32_t{ EPOLLOUT } : 0);
+		event.data.fd = connection.fd;
+		epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+		connection.writing = pending;
+	}
+	if (!pending && connection.session.getStatus() == GameSession::Status::Closing)
+		return close(connection), false;
+	return true;
+}
+
+void SessionServer::close(Connection& connection)
+{
+	int fd = connection.fd;
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+	::close(fd);
+	connections.erase(fd); // destroys the connection
+}
+
+void SessionServer::tickSessions()
+{
+	now = GameSession::Clock::now();
+	due.clear();
+	for (auto& [fd, connection] : connections)
+		if (connection->session.isDue(now))
+			due.push_back(connection.get());
+	if (due.empty())
+		return;
+	if (thread_count > 1)
+	{
+		start.arrive_and_wait();
+		tickShare(0);
+		finish.arrive_and_wait();
+	}
+	else
+		tickShare(0);
+	for (Connection* connection : due)
+		send(*connection);
+}
+
+void SessionServer::tickShare(size_t thread_index) noexcept
+{
+	for (size_t index = thread_index; index < due.size(); index += thread_count)
+	{
+		try {
+			due[index]->session.tick(now);
+		}
+		catch (const std::exception&) {} // out of memory, the frame is rendered later
+		catch (const Exception&) {}
+	}
+}
\ No newline at end of file
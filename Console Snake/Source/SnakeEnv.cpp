@@ -0,0 +1,139 @@
+﻿#include "SnakeEnv.h"
+#include "HeadlessVenue.h"
+#include "ObservationEncoder.h"
+#include "Exception.h"
+#include "Pythonic.h"
+
+#include <optional>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+struct SnakeEnv
+{
+	DynArray<MapNode, 2> map;
+	ObservationEncoder encoder;
+	std::span<std::byte> observation;
+	std::optional<HeadlessVenue> venue;
+	bool won = false;
+
+	// the game before is kept if the new one cannot be created
+	void reset(uint64_t seed)
+	{
+		std::optional<HeadlessVenue> next(std::in_place, map, seed);
+		venue.swap(next);
+		won = false;
+		encoder.encode(*venue, observation);
+	}
+};
+
+namespace
+{
+	std::optional<ObservationLayout> ToLayout(int layout) noexcept
+	{
+		switch (layout)
+		{
+			case SNAKE_OBSERVATION_PLANES:
+				return ObservationLayout::Planes;
+			case SNAKE_OBSERVATION_GRID:
+				return ObservationLayout::Grid;
+		}
+		return std::nullopt;
+	}
+} // namespace
+
+uint32_t snake_env_abi_version(void)
+{
+	return SNAKE_ENV_ABI_VERSION;
+}
+
+size_t snake_env_observation_size(uint32_t height, uint32_t width, int layout)
+{
+	auto observation_layout = ToLayout(layout);
+	return observation_layout ? ObservationEncoder::GetByteSize(*observation_layout, height, width) : 0;
+}
+
+SnakeEnv* snake_env_create(const uint8_t* map, uint32_t height, uint32_t width,
+						   uint64_t seed, int layout, void* observation, size_t observation_size)
+{
+	auto observation_layout = ToLayout(layout);
+	if (map == nullptr || observation == nullptr || !observation_layout ||
+		height < 2 || width < 2 || height > UINT8_MAX || width > UINT8_MAX ||
+		observation_size < ObservationEncoder::GetByteSize(*observation_layout, height, width))
+		return nullptr;
+	try
+	{
+		DynArray<MapNode, 2> nodes(height, width);
+		for (auto y : range(height))
+			for (auto x : range(width))
+				nodes[y][x].type = map[y * width + x] != 0 ? Element::Barrier : Element::Blank;
+		auto env = new SnakeEnv{
+			.map = std::move(nodes),
+			.encoder = ObservationEncoder(*observation_layout, height, width),
+			.observation = { static_cast<std::byte*>(observation), observation_size },
+			.venue = std::nullopt, // by reset
+		};
+		try
+		{
+			env->reset(seed);
+		}
+		catch (...)
+		{
+			delete env;
+			throw;
+		}
+		return env;
+	}
+	catch (...) // no exception crosses the C interface
+	{
+		return nullptr;
+	}
+}
+
+void snake_env_destroy(SnakeEnv* env)
+{
+	delete env;
+}
+
+int snake_env_reset(SnakeEnv* env, uint64_t seed)
+{
+	// the map is known to be valid since the first reset, only allocations fail
+	try
+	{
+		env->reset(seed);
+		return 0;
+	}
+	catch (...) // no exception crosses the C interface
+	{
+		return -1;
+	}
+}
+
+int snake_env_step(SnakeEnv* env, int direction, float* reward)
+{
+	auto& venue = *env->venue;
+	if (venue.isOver() || env->won)
+	{
+		if (reward)
+			*reward = 0.0f;
+		return 1;
+	}
+	if (direction < SNAKE_DIRECTION_NONE || direction > SNAKE_DIRECTION_DOWN)
+		direction = SNAKE_DIRECTION_NONE;
+	PosNodeGroup frame = venue.step(+static_cast<Direction::Tags>(direction));
+	env->encoder.update(venue, frame, env->observation);
+	env->won = venue.isWin();
+	if (reward)
+		*reward = frame.count == 0 ? -1.0f : frame.count == 1 ? 1.0f : 0.0f;
+	return venue.isOver() || env->won;
+}
+
+uint32_t snake_env_score(const SnakeEnv* env)
+{
+	return static_cast<uint32_t>(env->venue->getScore());
+}
+
+uint32_t snake_env_ticks(const SnakeEnv* env)
+{
+	return static_cast<uint32_t>(env->venue->getTicks());
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+﻿#include "Solver.h"
+
+#include <cstddef>
+
+Direction GreedySolver::solveNextStep(const Venue& venue)
+{
+	const auto length = venue.getSnakeLength();
+
+	Direction best = Direction::None;
+	bool best_roomy = false;
+	size_t best_room = 0;
+	uint32_t best_distance = 0;
+	for (auto& move : path_finder.surveyMoves(venue))
+	{
+		if (!move.legal)
+			continue;
+		bool roomy = move.reachable >= length;
+
+		// prefer enough room, then closer food, then more room
+		auto is_better = [&]
+			{
+				if (best == Direction::None)
+					return true;
+				if (roomy != best_roomy)
+					return roomy;
+				return roomy ? move.food_distance < best_distance : move.reachable > best_room;
+			};
+		if (is_better())
+		{
+			best = move.direct;
+			best_roomy = roomy;
+			best_room = move.reachable;
+			best_distance = move.food_distance;
+		}
+	}
+	return best;
+}
+
+std::wstring_view GreedySolver::name() const noexcept
+{
+	return L"Greedy";
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+﻿#include "SpawnField.h"
+#include "Pythonic.h"
+
+#include <mutex>
+#include <list>
+#include <utility>
+#include <algorithm>
+
+namespace
+{
+	constexpr Direction::Tags InitDirectMap[] =
+	{ Direction::Up, Direction::Left, Direction::Right, Direction::Down };
+	// the nodes behind the head, one and two steps away, for each direction
+	struct PosOffset
+	{
+		int x;
+		int y;
+	};
+	constexpr PosOffset InitDirectCalcOffset1[] = { { 0,+1 }, { +1,0 }, { -1,0 }, { 0,-1 } };
+	constexpr PosOffset InitDirectCalcOffset2[] = { { 0,+2 }, { +2,0 }, { -2,0 }, { 0,-2 } };
+	// the square around a node for its weight
+	constexpr int GenRadius = 2;
+	// 10^(room behind) for directions
+	constexpr uint16_t DirectWeights[] = { 1, 10, 100 };
+	// fields of the layouts used last, older ones live as long as their venues only
+	constexpr size_t FieldCacheCapacity = 16;
+
+	size_t Wrap(size_t pos, int offset, size_t size) noexcept
+	{
+		return (pos + size * GenRadius + offset) % size;
+	}
+
+	uint64_t HashLayout(size_t height, size_t width, const std::vector<uint64_t>& bits) noexcept
+	{
+		// FNV-1a
+		uint64_t hash = 0xCBF29CE484222325;
+		auto mix = [&](uint64_t value)
+			{
+				hash ^= value;
+				hash *= 0x100000001B3;
+			};
+		mix(height);
+		mix(width);
+		for (auto word : bits)
+			mix(word);
+		return hash;
+	}
+} // namespace
+
+SpawnField::SpawnField(const DynArray<MapNode, 2>& map)
+	: height(map.size(0)), width(map.size(1)), blank_bits(GetBlankBits(map))
+{
+	auto is_blank = [&](size_t x, size_t y)
+		{
+			size_t index = y * width + x;
+			return (blank_bits[index / 64] >> (index % 64) & 1) != 0;
+		};
+
+	// Summed-area table of blank nodes over the map padded by GenRadius on each side,
+	// the padding wraps around as the snake does. sums[y][x] covers [0, y) x [0, x).
+	const size_t padded_height = height + GenRadius * 2, padded_width = width + GenRadius * 2;
+	DynArray<uint32_t, 2> sums(padded_height + 1, padded_width + 1);
+	std::fill(sums.iter_all().begin(), sums.iter_all().end(), 0);
+	for (auto y : range(padded_height))
+	{
+		uint32_t row_sum = 0;
+		for (auto x : range(padded_width))
+		{
+			row_sum += is_blank(Wrap(x, -GenRadius, width), Wrap(y, -GenRadius, height));
+			sums[y + 1][x + 1] = sums[y][x + 1] + row_sum;
+		}
+	}
+
+	std::vector<uint64_t> weights;
+	for (auto y : range(height))
+	{
+		for (auto x : range(width))
+		{
+			if (!is_blank(x, y))
+				continue;
+			// the node itself and the blank nodes of the 5x5 square around, squared
+			constexpr size_t Side = GenRadius * 2 + 1;
+			uint64_t around = sums[y + Side][x + Side] - sums[y][x + Side] - sums[y + Side][x] + sums[y][x];
+			weights.push_back(around * around);
+
+			Node node{ .pos = { static_cast<uint8_t>(x), static_cast<uint8_t>(y) }, .direct_weights = {}, .direct_total = 0 };
+			for (auto i : range(DirectCount))
+			{
+				auto [x1, y1] = InitDirectCalcOffset1[i];
+				auto [x2, y2] = InitDirectCalcOffset2[i];
+				int room = is_blank(Wrap(x, x1, width), Wrap(y, y1, height)) +
+					is_blank(Wrap(x, x2, width), Wrap(y, y2, height));
+				node.direct_weights[i] = DirectWeights[room];
+				node.direct_total += DirectWeights[room];
+			}
+			nodes.push_back(node);
+		}
+	}
+	if (!nodes.empty())
+		node_table = AliasTable(weights);
+}
+
+std::shared_ptr<const SpawnField> SpawnField::Get(const DynArray<MapNode, 2>& map)
+{
+	static std::mutex mutex;
+	// the most recently used first
+	static std::list<std::pair<uint64_t, std::shared_ptr<const SpawnField>>> fields;
+
+	auto hash = HashLayout(map.size(0), map.size(1), GetBlankBits(map));
+	std::lock_guard lock(mutex);
+	auto found = std::find_if(fields.begin(), fields.end(),
+							  [&](auto& item) { return item.first == hash && item.second->isLayoutOf(map); });
+	if (found != fields.end())
+	{
+		fields.splice(fields.begin(), fields, found);
+		return found->second;
+	}
+	fields.emplace_front(hash, std::make_shared<const SpawnField>(map));
+	if (fields.size() > FieldCacheCapacity)
+		fields.pop_back();
+	return fields.front().second;
+}
+
+std::optional<SpawnField::Spawn> SpawnField::sample(FastRandom& engine) const noexcept
+{
+	if (nodes.empty())
+		return {};
+	auto& node = nodes[node_table(engine)];
+	uint32_t pick = engine.bounded(node.direct_total);
+	size_t direct = 0;
+	while (pick >= node.direct_weights[direct])
+		pick -= node.direct_weights[direct++];
+	return Spawn{ node.pos, InitDirectMap[direct] };
+}
+
+bool SpawnField::isLayoutOf(const DynArray<MapNode, 2>& map) const
+{
+	return map.size(0) == height && map.size(1) == width && GetBlankBits(map) == blank_bits;
+}
+
+std::vector<uint64_t> SpawnField::GetBlankBits(const DynArray<MapNode, 2>& map)
+{
+	std::vector<uint64_t> bits((map.total_size() + 63) / 64);
+	size_t index = 0;
+	for (auto& node : map.iter_all())
+	{
+		if (node.type == Element::Blank)
+			bits[index / 64] |= uint64_t{ 1 } << (index % 64);
+		index++;
+	}
+	return bits;
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+﻿#include "Timer.h"
+
+TimerService& TimerService::get()
+{
+	static TimerService service;
+	return service;
+}
+
+TimerService::TimerService()
+	: worker(&TimerService::work, this)
+{
+
+}
+
+TimerService::~TimerService() noexcept
+{
+	{
+		std::lock_guard lock(mutex);
+		stopping = true;
+	}
+	wakeup_signal.notify_one();
+	worker.join();
+}
+
+size_t TimerService::add(Task f, Task callback, Clock::duration delay, bool looping)
+{
+	std::unique_lock lock(mutex);
+	size_t id = next_id++;
+	auto deadline = Clock::now() + delay;
+	slots.emplace(id, Slot{ std::move(f), std::move(callback), delay, deadline, looping });
+	bool is_nearest = deadlines.empty() || deadline < deadlines.top().first;
+	deadlines.emplace(deadline, id);
+	lock.unlock();
+	if (is_nearest)
+		wakeup_signal.notify_one();
+	return id;
+}
+
+void TimerService::reset(size_t id) noexcept
+{
+	std::lock_guard lock(mutex);
+	if (auto iter = slots.find(id); iter != slots.end())
+		iter->second.deadline = Clock::now() + iter->second.delay; // only later than before
+}
+
+void TimerService::disable(size_t id) noexcept
+{
+	std::unique_lock lock(mutex);
+	auto iter = slots.find(id);
+	if (iter == slots.end() || !iter->second.enabled)
+		return;
+	if (std::this_thread::get_id() != worker.get_id() && running_id == id)
+	{
+		finish_signal.wait(lock, [&] { return running_id != id; });
+		// a one-shot slot is erased by the worker after f(), which calls the callback then
+		iter = slots.find(id);
+		if (iter == slots.end() || !iter->second.enabled)
+			return;
+	}
+	Task callback = std::move(iter->second.callback);
+	if (running_id == id)
+		iter->second.enabled = false; // disabled by its own f(), erased by the worker
+	else
+		slots.erase(iter);
+	lock.unlock();
+	callback();
+}
+
+void TimerService::loop(size_t id, bool looping) noexcept
+{
+	std::lock_guard lock(mutex);
+	if (auto iter = slots.find(id); iter != slots.end())
+		iter->second.looping = looping;
+}
+
+void TimerService::work() noexcept
+{
+	std::unique_lock lock(mutex);
+	while (!stopping)
+	{
+		if (deadlines.empty())
+		{
+			wakeup_signal.wait(lock);
+			continue;
+		}
+		auto [deadline, id] = deadlines.top();
+		auto iter = slots.find(id);
+		if (iter == slots.end())
+		{
+			deadlines.pop(); // disabled
+			continue;
+		}
+		Slot& slot = iter->second;
+		if (slot.deadline != deadline)
+		{
+			deadlines.pop(); // reset
+			deadlines.emplace(slot.deadline, id);
+			continue;
+		}
+		if (Clock::now() < deadline)
+		{
+			wakeup_signal.wait_until(lock, deadline);
+			continue;
+		}
+		deadlines.pop();
+
+		// the slot stays in place while running, unordered_map never moves its elements
+		running_id = id;
+		lock.unlock();
+		slot.f();
+		lock.lock();
+		running_id = 0;
+		finish_signal.notify_all();
+
+		if (!slot.enabled)
+		{
+			slots.erase(id);
+		}
+		else if (slot.looping)
+		{
+			slot.deadline = Clock::now() + slot.delay;
+			deadlines.emplace(slot.deadline, id);
+		}
+		else
+		{
+			Task callback = std::move(slot.callback);
+			slots.erase(id);
+			lock.unlock();
+			callback();
+			lock.lock();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+﻿#include "Tournament.h"
+#include "HeadlessVenue.h"
+#include "Pythonic.h"
+#include "Random.h"
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <optional>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+
+double TournamentResult::averageScore() const noexcept
+{
+	return games == 0 ? 0.0 : static_cast<double>(total_score) / games;
+}
+
+double TournamentResult::winRate() const noexcept
+{
+	return games == 0 ? 0.0 : static_cast<double>(wins) / games;
+}
+
+double TournamentResult::movesPerSecond() const noexcept
+{
+	return seconds == 0.0 ? 0.0 : total_moves / seconds;
+}
+
+namespace
+{
+	// Owner takes jobs from the back, thieves take them from the front.
+	template<typename T>
+	class StealingQueue
+	{
+	public:
+		void push(T job)
+		{
+			std::lock_guard lock(mutex);
+			jobs.push_back(std::move(job));
+		}
+		std::optional<T> pop()
+		{
+			std::lock_guard lock(mutex);
+			if (jobs.empty())
+				return {};
+			T job = std::move(jobs.back());
+			jobs.pop_back();
+			return job;
+		}
+		std::optional<T> steal()
+		{
+			std::lock_guard lock(mutex);
+			if (jobs.empty())
+				return {};
+			T job = std::move(jobs.front());
+			jobs.pop_front();
+			return job;
+		}
+
+	private:
+		std::mutex mutex;
+		std::deque<T> jobs;
+	};
+} // namespace
+
+Tournament::Tournament(DynArray<MapNode, 2> map_, size_t games_per_solver,
+					   size_t thread_count, size_t stall_limit)
+	: map(std::move(map_)), games_per_solver(games_per_solver)
+	, thread_count(thread_count), stall_limit(stall_limit), seed(GetRandomSeed())
+{
+	if (this->thread_count == 0)
+		this->thread_count = std::max(1u, std::thread::hardware_concurrency());
+	if (this->stall_limit == 0)
+		this->stall_limit = map.total_size() * 4;
+}
+
+void Tournament::addSolver(SolverFactory factory)
+{
+	factories.push_back(std::move(factory));
+}
+
+void Tournament::setSeed(uint64_t new_seed) noexcept
+{
+	seed = new_seed;
+}
+
+std::vector<TournamentResult> Tournament::run() const
+{
+	std::vector<StealingQueue<Job>> queues(thread_count);
+	// deal the jobs round-robin so that every solver spreads over all threads
+	size_t next_queue = 0;
+	for (auto game_index : range(games_per_solver))
+	{
+		for (auto solver_index : range(factories.size()))
+		{
+			queues[next_queue].push({ solver_index, seed + game_index });
+			next_queue = (next_queue + 1) % thread_count;
+		}
+	}
+
+	// every thread writes to its own results only
+	std::vector<std::vector<TournamentResult>> thread_results(
+		thread_count, std::vector<TournamentResult>(factories.size()));
+	auto worker = [&](size_t thread_index)
+		{
+			auto& results = thread_results[thread_index];
+			auto fetch_job = [&]() -> std::optional<Job>
+				{
+					if (auto job = queues[thread_index].pop())
+						return job;
+					for (auto offset : range<size_t>(1, thread_count))
+						if (auto job = queues[(thread_index + offset) % thread_count].steal())
+							return job;
+					return {};
+				};
+			while (auto job = fetch_job())
+			{
+				auto solver = factories[job->solver_index]();
+				auto begin = std::chrono::steady_clock::now();
+				auto game = playGame(*solver, job->seed);
+				std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+				auto& result = results[job->solver_index];
+				result.games++;
+				result.wins += game.win;
+				result.total_score += game.score;
+				result.total_moves += game.moves;
+				result.seconds += elapsed.count();
+			}
+		};
+
+	std::vector<std::jthread> threads;
+	for (auto thread_index : range(thread_count))
+		threads.emplace_back(worker, thread_index);
+	threads.clear(); // join
+
+	std::vector<TournamentResult> results(factories.size());
+	for (auto solver_index : range(factories.size()))
+	{
+		auto& total = results[solver_index];
+		total.solver_name = factories[solver_index]()->name();
+		for (auto& thread_result : thread_results)
+		{
+			auto& part = thread_result[solver_index];
+			total.games += part.games;
+			total.wins += part.wins;
+			total.total_score += part.total_score;
+			total.total_moves += part.total_moves;
+			total.seconds += part.seconds;
+		}
+	}
+	return results;
+}
+
+Tournament::GameResult Tournament::playGame(Solver& solver, uint64_t game_seed) const
+{
+	HeadlessVenue venue(map, game_seed);
+	size_t last_score = 0, stalled = 0;
+	while (!venue.isOver() && stalled < stall_limit)
+	{
+		venue.step(solver.solveNextStep(venue));
+		if (venue.getScore() != last_score)
+		{
+			last_score = venue.getScore();
+			stalled = 0;
+		}
+		else
+			stalled++;
+	}
+	return { venue.getScore(), venue.getTicks(), venue.isOver() && venue.isWin() };
+}
\ No newline at end of file
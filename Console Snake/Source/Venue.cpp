@@ -0,0 +1,613 @@
+﻿#include "Venue.h"
+#include "Random.h"
+#include "SpawnField.h"
+#include "Exception.h"
+#include "Pythonic.h"
+
+#include <utility>
+#include <algorithm>
+#include <vector>
+#include <iterator>
+#include <array>
+#include <bit>
+#include <ranges>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+	std::optional<OccupancyBoard> MakeOccupancy(const DynArray<MapNode, 2>& map)
+	{
+		if (map.size(1) > OccupancyBoard::MaxWidth)
+			return {};
+		OccupancyBoard board(map.size(0), map.size(1));
+		for (auto y : range(map.size(0)))
+			for (auto x : range(map.size(1)))
+				board.assign(map[y][x].type, x, y);
+		return board;
+	}
+
+	// Zobrist keys, derived from what they stand for by splitmix64 instead of kept in tables,
+	// so that hashes of the same state are equal across map sizes and processes
+	enum struct KeyKind :uint64_t
+	{
+		Food,
+		Head,
+		Body, // a snake node and the next node towards the head
+		Direction,
+	};
+	uint64_t ZobristKey(KeyKind kind, uint64_t which) noexcept
+	{
+		uint64_t z = (static_cast<uint64_t>(kind) << 32 | which) * 0x9E3779B97F4A7C15 + 0x632BE59BD9B4E019;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+		return z ^ (z >> 31);
+	}
+	uint64_t NodeCode(PosNode pos) noexcept
+	{
+		return static_cast<uint64_t>(pos.y) << 8 | pos.x;
+	}
+	uint64_t FoodKey(PosNode pos) noexcept
+	{
+		return ZobristKey(KeyKind::Food, NodeCode(pos));
+	}
+	uint64_t HeadKey(PosNode pos) noexcept
+	{
+		return ZobristKey(KeyKind::Head, NodeCode(pos));
+	}
+	uint64_t BodyKey(PosNode pos, PosNode next) noexcept
+	{
+		return ZobristKey(KeyKind::Body, NodeCode(pos) << 16 | NodeCode(next));
+	}
+	uint64_t DirectionKey(Direction direct) noexcept
+	{
+		return ZobristKey(KeyKind::Direction, +direct);
+	}
+
+	size_t GetMapBlankCount(const DynArray<MapNode, 2>& map,
+							const std::optional<OccupancyBoard>& occupancy)
+	{
+		if (occupancy)
+			return occupancy->count(Element::Blank);
+		size_t count = 0;
+		for (auto& node : map.iter_all())
+		{
+			if (node.type == Element::Blank)
+				count++;
+		}
+		return count;
+	}
+} // namespace
+
+template<CellStorage Storage>
+BasicVenue<Storage>::BasicVenue(DynArray<MapNode, 2> map)
+	: BasicVenue(std::move(map), GetRandomSeed())
+{
+
+}
+
+template<CellStorage Storage>
+BasicVenue<Storage>::BasicVenue(DynArray<MapNode, 2> map, uint64_t seed)
+	: cells(map), occupancy(MakeOccupancy(map))
+	, snake_body(GetMapBlankCount(map, occupancy)), random_engine(seed)
+{
+	setupInvariant();
+	createSnake(map);
+	state_hash = computeStateHash();
+	generateFood();
+}
+
+template<CellStorage Storage>
+PosNode BasicVenue<Storage>::getNextPosition() const noexcept
+{
+	auto [x, y] = snake_body[snake_head_index];
+	nextPosition(x, y, snake_direct);
+	return { x, y };
+}
+
+template<CellStorage Storage>
+PosNode BasicVenue<Storage>::getAdjacentPosition(PosNode pos, Direction direct) const noexcept
+{
+	nextPosition(pos.x, pos.y, direct);
+	return pos;
+}
+
+template<CellStorage Storage>
+PosNode BasicVenue<Storage>::getSnakeHead() const noexcept
+{
+	return snake_body[snake_head_index];
+}
+
+template<CellStorage Storage>
+uint64_t BasicVenue<Storage>::getStateHash() const noexcept
+{
+	return state_hash;
+}
+
+template<CellStorage Storage>
+uint64_t BasicVenue<Storage>::computeStateHash() const noexcept
+{
+	uint64_t hash = DirectionKey(snake_direct);
+	if (food)
+		hash ^= FoodKey(*food);
+	for (int16_t index = snake_tail_index; index != snake_head_index;)
+	{
+		auto node = snake_body[index];
+		forwardIndex(index);
+		hash ^= BodyKey(node, snake_body[index]);
+	}
+	return hash ^ HeadKey(snake_body[snake_head_index]);
+}
+
+template<CellStorage Storage>
+PosNode BasicVenue<Storage>::getSnakeTail() const noexcept
+{
+	return snake_body[snake_tail_index];
+}
+
+template<CellStorage Storage>
+Direction BasicVenue<Storage>::getSnakeDirection() const noexcept
+{
+	return snake_direct;
+}
+
+template<CellStorage Storage>
+size_t BasicVenue<Storage>::getSnakeLength() const noexcept
+{
+	if (snake_tail_index >= snake_head_index)
+		return snake_tail_index - snake_head_index + 1;
+	return snake_body.total_size() - (snake_head_index - snake_tail_index - 1);
+}
+
+template<CellStorage Storage>
+std::optional<PosNode> BasicVenue<Storage>::getFoodPosition() const noexcept
+{
+	return food;
+}
+
+template<CellStorage Storage>
+Element BasicVenue<Storage>::getPositionType(uint8_t x, uint8_t y) const noexcept
+{
+	if (occupancy)
+		return occupancy->get(x, y);
+	return cells.getType(x, y);
+}
+
+template<CellStorage Storage>
+size_t BasicVenue<Storage>::getHeight() const noexcept
+{
+	return cells.height();
+}
+
+template<CellStorage Storage>
+size_t BasicVenue<Storage>::getWidth() const noexcept
+{
+	return cells.width();
+}
+
+template<CellStorage Storage>
+size_t BasicVenue<Storage>::getBlankCount() const noexcept
+{
+	if (occupancy)
+		return occupancy->count(Element::Blank);
+	size_t count = 0;
+	for (auto y : range(cells.height()))
+		for (auto x : range(cells.width()))
+			count += cells.getType(x, y) == Element::Blank;
+	return count;
+}
+
+template<CellStorage Storage>
+size_t BasicVenue<Storage>::getReachableCount(uint8_t x, uint8_t y) const noexcept
+{
+	if (occupancy)
+	{
+		uint64_t scratch[UINT8_MAX + 1];
+		return occupancy->countReachable(x, y, scratch);
+	}
+
+	auto is_free = [this](PosNode pos)
+		{
+			auto type = cells.getType(pos.x, pos.y);
+			return type == Element::Blank || type == Element::Food;
+		};
+	if (!is_free({ x, y }))
+		return 0;
+	DynArray<bool, 2> visited(cells.height(), cells.width());
+	std::fill(visited.iter_all().begin(), visited.iter_all().end(), false);
+	std::vector<PosNode> pending{ { x, y } };
+	visited[y][x] = true;
+	size_t count = 0;
+	while (!pending.empty())
+	{
+		PosNode pos = pending.back();
+		pending.pop_back();
+		count++;
+		for (auto direct : { Direction::Up, Direction::Left, Direction::Right, Direction::Down })
+		{
+			PosNode next = pos;
+			nextPosition(next.x, next.y, direct);
+			if (!visited[next.y][next.x] && is_free(next))
+			{
+				visited[next.y][next.x] = true;
+				pending.push_back(next);
+			}
+		}
+	}
+	return count;
+}
+
+template<CellStorage Storage>
+size_t BasicVenue<Storage>::getSnapshotSize() const noexcept
+{
+	return sizeof(SnapshotHeader) + cells.getByteSize() +
+		snake_body.total_size() * sizeof(PosNode) +
+		(occupancy ? occupancy->words().size_bytes() : 0);
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::snapshot(std::span<std::byte> buffer) const noexcept
+{
+	static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+	static_assert(std::is_trivially_copyable_v<PosNode>);
+	assert(buffer.size() == getSnapshotSize());
+	SnapshotHeader header{
+		.map_size = cells.height() * cells.width(),
+		.snake_head_index = snake_head_index,
+		.snake_tail_index = snake_tail_index,
+		.snake_init_length = snake_init_length,
+		.snake_direct = snake_direct,
+		.has_food = food.has_value(),
+		.food = food.value_or(PosNode{}),
+		.state_hash = state_hash,
+		.random_engine = random_engine,
+	};
+	std::byte* dest = buffer.data();
+	auto write = [&](const void* source, size_t size)
+		{
+			std::memcpy(dest, source, size);
+			dest += size;
+		};
+	write(&header, sizeof(header));
+	cells.save({ dest, cells.getByteSize() });
+	dest += cells.getByteSize();
+	write(snake_body.iter_all().begin(), snake_body.total_size() * sizeof(PosNode));
+	if (occupancy)
+		write(occupancy->words().data(), occupancy->words().size_bytes());
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::restore(std::span<const std::byte> buffer) noexcept
+{
+	assert(buffer.size() == getSnapshotSize());
+	const std::byte* source = buffer.data();
+	auto read = [&](void* dest, size_t size)
+		{
+			std::memcpy(dest, source, size);
+			source += size;
+		};
+	std::array<std::byte, sizeof(SnapshotHeader)> header_bytes;
+	read(header_bytes.data(), header_bytes.size());
+	auto header = std::bit_cast<SnapshotHeader>(header_bytes);
+	assert(header.map_size == cells.height() * cells.width());
+	snake_head_index = header.snake_head_index;
+	snake_tail_index = header.snake_tail_index;
+	snake_init_length = header.snake_init_length;
+	snake_direct = header.snake_direct;
+	food = header.has_food ? std::optional(header.food) : std::nullopt;
+	state_hash = header.state_hash;
+	random_engine = header.random_engine;
+	cells.load({ source, cells.getByteSize() });
+	source += cells.getByteSize();
+	read(snake_body.iter_all().begin(), snake_body.total_size() * sizeof(PosNode));
+	if (occupancy)
+		read(occupancy->words().data(), occupancy->words().size_bytes());
+}
+
+template<CellStorage Storage>
+std::optional<PosNode> BasicVenue<Storage>::generateFood()
+{
+	size_t range;
+	// get usable range for food generating
+	if (snake_head_index > snake_tail_index)
+		range = snake_head_index - snake_tail_index - 1;
+	else
+		range = snake_body.total_size() - (snake_tail_index - snake_head_index + 1);
+	if (range == 0)
+		return {};
+
+	// pick random position of food
+	size_t random_index = random_engine.between<size_t>(1, range) + snake_tail_index;
+	if (random_index >= snake_body.total_size())
+		random_index -= snake_body.total_size();
+
+	// generate food on the map
+	auto [x, y] = snake_body[random_index];
+	setNodeType(x, y, Element::Food);
+	food = PosNode{ x, y };
+	state_hash ^= FoodKey(*food);
+	return food;
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::orderDirection(Direction input) noexcept
+{
+	assert(snake_head_index != -1 && snake_tail_index != -1);
+	if (input != Direction::None && !input.isConflictWith(snake_direct))
+	{
+		state_hash ^= DirectionKey(snake_direct) ^ DirectionKey(input);
+		snake_direct = input;
+	}
+}
+
+template<CellStorage Storage>
+PosNodeGroup BasicVenue<Storage>::updateFrame() noexcept
+{
+	auto old_head = snake_body[snake_head_index];
+	auto [head_x, head_y] = old_head;
+	nextPosition(head_x, head_y, snake_direct);
+
+	auto previous_type = getPositionType(head_x, head_y);
+	if (previous_type == Element::Barrier || previous_type == Element::Snake)
+		return { 0, {}, {} };
+
+	setNodeType(head_x, head_y, Element::Snake);
+	forwardIndex(snake_head_index);
+	rebindData(snake_head_index, head_x, head_y);
+	state_hash ^= HeadKey(old_head) ^ BodyKey(old_head, { head_x, head_y }) ^ HeadKey({ head_x, head_y });
+
+	if (previous_type == Element::Food)
+	{
+		state_hash ^= FoodKey(*food);
+		food.reset();
+		return { 1, { head_x, head_y }, {} };
+	}
+
+	auto tail = snake_body[snake_tail_index];
+	auto [tail_x, tail_y] = tail;
+	setNodeType(tail_x, tail_y, Element::Blank);
+	forwardIndex(snake_tail_index);
+	state_hash ^= BodyKey(tail, snake_body[snake_tail_index]);
+	// no need to rebind
+	return { 2, { head_x, head_y }, { tail_x, tail_y } };
+}
+
+template<CellStorage Storage>
+bool BasicVenue<Storage>::isWin(size_t score) const noexcept
+{
+	return score + snake_init_length == snake_body.size();
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::setupInvariant() noexcept
+{
+	int16_t index = 0;
+	for (auto row : range<uint8_t>(cells.height()))
+	{
+		for (auto column : range<uint8_t>(cells.width()))
+		{
+			if (cells.getType(column, row) == Element::Blank)
+			{
+				cells.setIndex(column, row, index);
+				snake_body[index].x = column;
+				snake_body[index].y = row;
+				index++;
+			}
+		}
+	}
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::setNodeType(uint8_t x, uint8_t y, Element type) noexcept
+{
+	cells.setType(x, y, type);
+	if (occupancy)
+		occupancy->assign(type, x, y);
+}
+
+namespace
+{
+	struct SquareMapInfo
+	{
+		uint8_t margin_up = 0;
+		uint8_t margin_down = 0;
+		uint8_t margin_left = 0;
+		uint8_t margin_right = 0;
+	};
+	std::optional<SquareMapInfo> IsSquareMap(const DynArray<MapNode, 2>& map) noexcept
+	{
+		auto g = [](auto map_slice, auto inner_range) -> bool
+			{
+				for (auto i : inner_range)
+					if (map_slice(i).type == Element::Blank)
+						return true;
+				return false;
+			};
+		auto f = [&](auto slice_functor, auto outer_range, auto inner_range, auto& counter)
+			{
+				for (auto i : outer_range)
+				{
+					if (g(slice_functor(i), inner_range))
+						break;
+					counter++;
+				}
+			};
+		auto slice_y = [&](auto y) { return [&, y](auto x) { return map[y][x]; }; };
+		auto slice_x = [&](auto x) { return [&, x](auto y) { return map[y][x]; }; };
+
+		SquareMapInfo info;
+		f(slice_y, range(map.size(0)), range(map.size(1)), info.margin_up);
+		f(slice_y, range(map.size(0)) | std::views::reverse, range(map.size(1)), info.margin_down);
+		f(slice_x, range(map.size(1)), range(map.size(0)), info.margin_left);
+		f(slice_x, range(map.size(1)) | std::views::reverse, range(map.size(0)), info.margin_right);
+
+		for (auto y : range(info.margin_up, map.size(0) - info.margin_down))
+		{
+			for (auto x : range(info.margin_left, map.size(1) - info.margin_right))
+			{
+				if (map[y][x].type != Element::Blank)
+					return {};
+			}
+		}
+		if (info.margin_up + info.margin_down + info.margin_left + info.margin_right == 0)
+			return {};
+		return info;
+	}
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::createSnake(const DynArray<MapNode, 2>& map)
+{
+	Direction init_direction;
+	uint8_t pos_x, pos_y;
+
+	if (auto square_info = IsSquareMap(map); !square_info.has_value()) // general algorithm
+	{
+		auto spawn = SpawnField::Get(map)->sample(random_engine);
+		if (!spawn)
+			throw RuntimeException(L"Invalid Map.");
+		init_direction = spawn->direct;
+		pos_x = spawn->pos.x;
+		pos_y = spawn->pos.y;
+	}
+	else // specialized algorithm for square-type maps
+	{
+		auto y_range = map.size(0) - square_info->margin_up - square_info->margin_down;
+		auto x_range = map.size(1) - square_info->margin_left - square_info->margin_right;
+		if (y_range > map.size(0) || x_range > map.size(1))
+			throw RuntimeException(L"Invalid Map.");
+		pos_y = static_cast<uint8_t>(random_engine.bounded(static_cast<uint32_t>(y_range)));
+		pos_x = static_cast<uint8_t>(random_engine.bounded(static_cast<uint32_t>(x_range)));
+
+		if (bool select_x_axis = random_engine.bounded(2))
+		{
+			if (pos_x < x_range / 2)
+				init_direction = Direction::Right;
+			else
+				init_direction = Direction::Left;
+		}
+		else
+		{
+			if (pos_y < y_range / 2)
+				init_direction = Direction::Down;
+			else
+				init_direction = Direction::Up;
+		}
+		pos_x += square_info->margin_left;
+		pos_y += square_info->margin_up;
+	}
+
+	addSnakeBody(init_direction, pos_x, pos_y);
+	for ([[maybe_unused]] auto _ : range(SnakeIntendedInitLength - 1))
+		addSnakeBody(-init_direction);
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::addSnakeBody(Direction head_direct, uint8_t head_x, uint8_t head_y) noexcept
+{
+	assert(snake_head_index == -1 && snake_tail_index == -1 &&
+		   snake_direct == Direction::None);
+	snake_direct = head_direct;
+	assert(cells.getType(head_x, head_y) == Element::Blank);
+	setNodeType(head_x, head_y, Element::Snake);
+	snake_tail_index = snake_head_index = cells.getIndex(head_x, head_y);
+	rebindData(snake_head_index, head_x, head_y);
+	snake_init_length++;
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::addSnakeBody(Direction tail_direct) noexcept
+{
+	assert(snake_head_index != -1 && snake_tail_index != -1);
+	if (tail_direct == snake_direct)
+		return;
+	auto [tail_x, tail_y] = snake_body[snake_tail_index];
+	nextPosition(tail_x, tail_y, tail_direct);
+	if (getPositionType(tail_x, tail_y) != Element::Blank)
+		return;
+	setNodeType(tail_x, tail_y, Element::Snake);
+	backwardIndex(snake_tail_index);
+	rebindData(snake_tail_index, tail_x, tail_y);
+	snake_init_length++;
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::rebindData(int16_t index, uint8_t x, uint8_t y) noexcept
+{
+	// maintain class invariant
+	int16_t temp_index = cells.getIndex(x, y);
+	uint8_t temp_x = snake_body[index].x;
+	uint8_t temp_y = snake_body[index].y;
+	cells.setIndex(x, y, cells.getIndex(temp_x, temp_y));
+	cells.setIndex(temp_x, temp_y, temp_index);
+	std::swap(snake_body[index], snake_body[temp_index]);
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::forwardIndex(int16_t& index) const noexcept
+{
+	index = index == 0
+		? static_cast<int16_t>(snake_body.total_size() - 1)
+		: index - 1;
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::backwardIndex(int16_t& index) const noexcept
+{
+	index = index == static_cast<int16_t>(snake_body.total_size() - 1)
+		? 0
+		: index + 1;
+}
+
+template<CellStorage Storage>
+void BasicVenue<Storage>::nextPosition(uint8_t& x, uint8_t& y, Direction direct) const noexcept
+{
+	if constexpr (requires { typename Storage::RowWrap; typename Storage::ColumnWrap; })
+	{
+		switch (+direct)
+		{
+			case Direction::Up:
+				y = Storage::RowWrap::Previous[y];
+				break;
+			case Direction::Down:
+				y = Storage::RowWrap::Next[y];
+				break;
+			case Direction::Left:
+				x = Storage::ColumnWrap::Previous[x];
+				break;
+			case Direction::Right:
+				x = Storage::ColumnWrap::Next[x];
+				break;
+			default:
+				break;
+		}
+		return;
+	}
+	uint8_t height = static_cast<uint8_t>(cells.height());
+	uint8_t width = static_cast<uint8_t>(cells.width());
+	switch (+direct)
+	{
+		case Direction::Up:
+			y == 0 ? y = height - 1 : y--;
+			break;
+		case Direction::Down:
+			y == height - 1 ? y = 0 : y++;
+			break;
+		case Direction::Left:
+			x == 0 ? x = width - 1 : x--;
+			break;
+		case Direction::Right:
+			x == width - 1 ? x = 0 : x++;
+			break;
+		default:
+			break;
+	}
+}
+
+template class BasicVenue<PackedCells>;
+template class BasicVenue<CellPlanes>;
+template class BasicVenue<FixedCells<15, 15>>;
+template class BasicVenue<FixedCells<20, 20>>;
+template class BasicVenue<FixedCells<24, 24>>;
\ No newline at end of file
@@ -0,0 +1,372 @@
+﻿#include "VenueBatch.h"
+#include "Exception.h"
+#include "Pythonic.h"
+
+#include <algorithm>
+#include <utility>
+#include <cassert>
+
+namespace
+{
+	constexpr Direction::Tags Candidates[] =
+	{ Direction::Up, Direction::Left, Direction::Right, Direction::Down };
+} // namespace
+
+VenueBatch::VenueBatch(const DynArray<MapNode, 2>& map, size_t batch_size, uint64_t seed, size_t stall_limit)
+	: height(map.size(0)), width(map.size(1)), cell_count(height * width), free_count(0)
+	, batch_size(batch_size), stall_limit(stall_limit != 0 ? stall_limit : cell_count * 4), seed(seed)
+{
+	// PosNode holds coordinates up to 255
+	if (height < 2 || width < 2 || height > UINT8_MAX || width > UINT8_MAX || batch_size == 0)
+		throw RuntimeException(L"Invalid Map.");
+
+	// barriers of the map are kept, other nodes start blank
+	DynArray<MapNode, 2> layout(height, width);
+	blank_types.resize(cell_count);
+	blank_ring_indices.resize(cell_count);
+	for (auto y : range(height))
+	{
+		for (auto x : range(width))
+		{
+			auto cell = static_cast<CellIndex>(y * width + x);
+			Element type = map[y][x].type == Element::Barrier ? Element::Barrier : Element::Blank;
+			layout[y][x].type = blank_types[cell] = type;
+			if (type == Element::Blank)
+			{
+				blank_ring_indices[cell] = static_cast<CellIndex>(blank_ring.size());
+				blank_ring.push_back(cell);
+			}
+		}
+	}
+	free_count = blank_ring.size();
+	if (free_count == 0)
+		throw RuntimeException(L"Invalid Map.");
+	spawn_field = SpawnField::Get(layout);
+
+	neighbors.resize(cell_count * 4);
+	for (auto cell : range(cell_count))
+	{
+		for (Direction direct : Candidates)
+		{
+			size_t x = cell % width, y = cell / width;
+			switch (+direct)
+			{
+				case Direction::Up:
+					y = y == 0 ? height - 1 : y - 1;
+					break;
+				case Direction::Down:
+					y = y == height - 1 ? 0 : y + 1;
+					break;
+				case Direction::Left:
+					x = x == 0 ? width - 1 : x - 1;
+					break;
+				case Direction::Right:
+					x = x == width - 1 ? 0 : x + 1;
+					break;
+				default:
+					break;
+			}
+			neighbors[cell * 4 + +direct - 1] = static_cast<CellIndex>(y * width + x);
+		}
+	}
+
+	types.resize(batch_size * cell_count);
+	ring_indices.resize(batch_size * cell_count);
+	ring.resize(batch_size * free_count);
+	head_indices.resize(batch_size);
+	tail_indices.resize(batch_size);
+	directions.resize(batch_size);
+	foods.resize(batch_size);
+	scores.resize(batch_size);
+	ticks.resize(batch_size);
+	final_scores.resize(batch_size);
+	final_ticks.resize(batch_size);
+	stalls.resize(batch_size);
+	episodes.resize(batch_size);
+	random_engines.reserve(batch_size);
+	for (auto game : range(batch_size))
+		random_engines.emplace_back(seed + game);
+	rewards.resize(batch_size);
+	dones.resize(batch_size);
+	for (auto game : range(batch_size))
+		reset(game);
+}
+
+void VenueBatch::step(std::span<const Direction> actions) noexcept
+{
+	for (auto shard : range(getShardCount()))
+		stepShard(shard, actions);
+}
+
+void VenueBatch::stepShard(size_t shard, std::span<const Direction> actions) noexcept
+{
+	assert(actions.size() == batch_size && shard < getShardCount());
+	size_t end = std::min(batch_size, (shard + 1) * ShardSize);
+	for (size_t game = shard * ShardSize; game < end; game++)
+		stepGame(game, actions[game]);
+}
+
+void VenueBatch::reset(size_t game) noexcept
+{
+	Element* board = types.data() + game * cell_count;
+	CellIndex* game_ring = ring.data() + game * free_count;
+	std::copy(blank_types.begin(), blank_types.end(), board);
+	std::copy(blank_ring.begin(), blank_ring.end(), game_ring);
+	std::copy(blank_ring_indices.begin(), blank_ring_indices.end(), ring_indices.begin() + game * cell_count);
+	scores[game] = 0;
+	ticks[game] = 0;
+	stalls[game] = 0;
+	auto& random_engine = random_engines[game];
+	if (uint64_t episode = episodes[game]++; episode != 0)
+		random_engine.reseed(seed + game + batch_size * episode);
+
+	// as Venue::createSnake() does, the blank ring is in place for the head
+	auto spawn = spawn_field->sample(random_engine);
+	assert(spawn.has_value());
+	auto head = static_cast<CellIndex>(spawn->pos.y * width + spawn->pos.x);
+	directions[game] = spawn->direct;
+	board[head] = Element::Snake;
+	head_indices[game] = tail_indices[game] = blank_ring_indices[head];
+	for ([[maybe_unused]] auto _ : range(SnakeInitLength - 1))
+	{
+		CellIndex tail = neighbors[game_ring[tail_indices[game]] * 4 + +(-spawn->direct) - 1];
+		if (board[tail] != Element::Blank)
+			break;
+		board[tail] = Element::Snake;
+		tail_indices[game] = backwardIndex(tail_indices[game]);
+		rebindData(game, tail_indices[game], tail);
+	}
+	foods[game] = NoFood;
+	generateFood(game);
+}
+
+size_t VenueBatch::size() const noexcept
+{
+	return batch_size;
+}
+
+size_t VenueBatch::getShardCount() const noexcept
+{
+	return (batch_size + ShardSize - 1) / ShardSize;
+}
+
+size_t VenueBatch::getHeight() const noexcept
+{
+	return height;
+}
+
+size_t VenueBatch::getWidth() const noexcept
+{
+	return width;
+}
+
+std::span<const Element> VenueBatch::getBoards() const noexcept
+{
+	return types;
+}
+
+std::span<const Element> VenueBatch::getBoard(size_t game) const noexcept
+{
+	return std::span(types).subspan(game * cell_count, cell_count);
+}
+
+std::span<const float> VenueBatch::getRewards() const noexcept
+{
+	return rewards;
+}
+
+std::span<const uint8_t> VenueBatch::getDones() const noexcept
+{
+	return dones;
+}
+
+std::span<const uint32_t> VenueBatch::getScores() const noexcept
+{
+	return scores;
+}
+
+std::span<const uint32_t> VenueBatch::getTicks() const noexcept
+{
+	return ticks;
+}
+
+std::span<const uint32_t> VenueBatch::getFinalScores() const noexcept
+{
+	return final_scores;
+}
+
+std::span<const uint32_t> VenueBatch::getFinalTicks() const noexcept
+{
+	return final_ticks;
+}
+
+PosNode VenueBatch::getSnakeHead(size_t game) const noexcept
+{
+	return toPosition(ring[game * free_count + head_indices[game]]);
+}
+
+Direction VenueBatch::getSnakeDirection(size_t game) const noexcept
+{
+	return directions[game];
+}
+
+size_t VenueBatch::getSnakeLength(size_t game) const noexcept
+{
+	size_t head_index = head_indices[game], tail_index = tail_indices[game];
+	return tail_index >= head_index
+		? tail_index - head_index + 1
+		: free_count - (head_index - tail_index - 1);
+}
+
+std::optional<PosNode> VenueBatch::getFoodPosition(size_t game) const noexcept
+{
+	if (foods[game] == NoFood)
+		return std::nullopt;
+	return toPosition(foods[game]);
+}
+
+void VenueBatch::stepGame(size_t game, Direction action) noexcept
+{
+	Element* board = types.data() + game * cell_count;
+	const CellIndex* game_ring = ring.data() + game * free_count;
+	Direction& direct = directions[game];
+	if (action != Direction::None && !action.isConflictWith(direct))
+		direct = action;
+	ticks[game]++;
+
+	CellIndex head = neighbors[game_ring[head_indices[game]] * 4 + +direct - 1];
+	Element previous_type = board[head];
+	if (previous_type == Element::Barrier || previous_type == Element::Snake)
+	{
+		rewards[game] = -1.0f;
+		dones[game] = true;
+		finishEpisode(game);
+		return;
+	}
+	board[head] = Element::Snake;
+	head_indices[game] = forwardIndex(head_indices[game]);
+	rebindData(game, head_indices[game], head);
+
+	if (previous_type == Element::Food)
+	{
+		scores[game]++;
+		stalls[game] = 0;
+		rewards[game] = 1.0f;
+		foods[game] = NoFood;
+		generateFood(game);
+		dones[game] = foods[game] == NoFood; // no room left, won
+	}
+	else
+	{
+		CellIndex& tail_index = tail_indices[game];
+		board[game_ring[tail_index]] = Element::Blank;
+		tail_index = forwardIndex(tail_index);
+		rewards[game] = 0.0f;
+		dones[game] = ++stalls[game] >= stall_limit;
+	}
+	if (dones[game])
+		finishEpisode(game);
+}
+
+void VenueBatch::finishEpisode(size_t game) noexcept
+{
+	final_scores[game] = scores[game];
+	final_ticks[game] = ticks[game];
+	reset(game);
+}
+
+void VenueBatch::generateFood(size_t game) noexcept
+{
+	// the same as Venue::generateFood()
+	size_t head_index = head_indices[game], tail_index = tail_indices[game];
+	size_t range;
+	if (head_index > tail_index)
+		range = head_index - tail_index - 1;
+	else
+		range = free_count - (tail_index - head_index + 1);
+	if (range == 0)
+		return;
+
+	size_t random_index = random_engines[game].between<size_t>(1, range) + tail_index;
+	if (random_index >= free_count)
+		random_index -= free_count;
+	CellIndex cell = ring[game * free_count + random_index];
+	types[game * cell_count + cell] = Element::Food;
+	foods[game] = cell;
+}
+
+void VenueBatch::rebindData(size_t game, CellIndex ring_index, CellIndex cell) noexcept
+{
+	// maintain the invariant, as Venue::rebindData() does
+	CellIndex* game_ring = ring.data() + game * free_count;
+	CellIndex* indices = ring_indices.data() + game * cell_count;
+	CellIndex temp_index = indices[cell];
+	CellIndex temp_cell = game_ring[ring_index];
+	indices[cell] = indices[temp_cell];
+	indices[temp_cell] = temp_index;
+	std::swap(game_ring[ring_index], game_ring[temp_index]);
+}
+
+VenueBatch::CellIndex VenueBatch::forwardIndex(CellIndex index) const noexcept
+{
+	return index == 0 ? static_cast<CellIndex>(free_count - 1) : index - 1;
+}
+
+VenueBatch::CellIndex VenueBatch::backwardIndex(CellIndex index) const noexcept
+{
+	return index == free_count - 1 ? 0 : index + 1;
+}
+
+PosNode VenueBatch::toPosition(CellIndex cell) const noexcept
+{
+	return { static_cast<uint8_t>(cell % width), static_cast<uint8_t>(cell / width) };
+}
+
+VenueBatchThreads::VenueBatchThreads(VenueBatch& batch, size_t thread_count)
+	: batch(batch)
+	, thread_count(std::clamp<size_t>(thread_count != 0 ? thread_count : std::thread::hardware_concurrency(),
+									  1, batch.getShardCount()))
+	, start(static_cast<ptrdiff_t>(this->thread_count))
+	, finish(static_cast<ptrdiff_t>(this->thread_count))
+{
+	for (auto thread_index : range<size_t>(1, this->thread_count))
+	{
+		threads.emplace_back([this, thread_index]
+			{
+				while (true)
+				{
+					start.arrive_and_wait();
+					if (stopping)
+						return;
+					stepShards(thread_index);
+					finish.arrive_and_wait();
+				}
+			});
+	}
+}
+
+VenueBatchThreads::~VenueBatchThreads()
+{
+	stopping = true;
+	start.arrive_and_wait();
+	threads.clear(); // join
+}
+
+void VenueBatchThreads::step(std::span<const Direction> actions) noexcept
+{
+	this->actions = actions;
+	start.arrive_and_wait();
+	stepShards(0);
+	finish.arrive_and_wait();
+}
+
+size_t VenueBatchThreads::getThreadCount() const noexcept
+{
+	return thread_count;
+}
+
+void VenueBatchThreads::stepShards(size_t thread_index) noexcept
+{
+	for (size_t shard = thread_index; shard < batch.getShardCount(); shard += thread_count)
+		batch.stepShard(shard, actions);
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+﻿#include "VenueSnapshot.h"
+
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+
+VenueSnapshot::VenueSnapshot(size_t size)
+{
+	resize(size);
+}
+
+VenueSnapshot::VenueSnapshot(const VenueSnapshot& other)
+{
+	*this = other;
+}
+
+VenueSnapshot::VenueSnapshot(VenueSnapshot&& other) noexcept
+	: buffer(std::move(other.buffer))
+	, buffer_size(std::exchange(other.buffer_size, 0))
+	, buffer_capacity(std::exchange(other.buffer_capacity, 0))
+{
+
+}
+
+VenueSnapshot& VenueSnapshot::operator=(const VenueSnapshot& other)
+{
+	if (this == &other)
+		return *this;
+	resize(other.buffer_size);
+	std::memcpy(buffer.get(), other.buffer.get(), buffer_size);
+	return *this;
+}
+
+VenueSnapshot& VenueSnapshot::operator=(VenueSnapshot&& other) noexcept
+{
+	buffer = std::move(other.buffer);
+	buffer_size = std::exchange(other.buffer_size, 0);
+	buffer_capacity = std::exchange(other.buffer_capacity, 0);
+	return *this;
+}
+
+std::span<std::byte> VenueSnapshot::data() noexcept
+{
+	return { buffer.get(), buffer_size };
+}
+
+std::span<const std::byte> VenueSnapshot::data() const noexcept
+{
+	return { buffer.get(), buffer_size };
+}
+
+size_t VenueSnapshot::size() const noexcept
+{
+	return buffer_size;
+}
+
+void VenueSnapshot::resize(size_t new_size)
+{
+	if (new_size > buffer_capacity)
+	{
+		buffer = std::make_unique_for_overwrite<std::byte[]>(new_size);
+		buffer_capacity = new_size;
+	}
+	buffer_size = new_size;
+}
+
+SnapshotArena::SnapshotArena(size_t snapshot_size, size_t slots_per_block)
+	: snapshot_size(snapshot_size)
+	, slot_stride((snapshot_size + SlotAlignment - 1) / SlotAlignment * SlotAlignment)
+	, slots_per_block(slots_per_block)
+{
+	assert(snapshot_size != 0 && slots_per_block != 0);
+}
+
+std::span<std::byte> SnapshotArena::acquire()
+{
+	if (free_slots.empty())
+		grow();
+	std::byte* slot = free_slots.back();
+	free_slots.pop_back();
+	return { slot, snapshot_size };
+}
+
+void SnapshotArena::release(std::span<std::byte> slot) noexcept
+{
+	assert(slot.size() == snapshot_size);
+	free_slots.push_back(slot.data()); // never reallocates, the capacity covers all slots
+}
+
+size_t SnapshotArena::getSnapshotSize() const noexcept
+{
+	return snapshot_size;
+}
+
+size_t SnapshotArena::getSlotCount() const noexcept
+{
+	return blocks.size() * slots_per_block;
+}
+
+void SnapshotArena::grow()
+{
+	// over-allocate to align the first slot
+	auto& block = blocks.emplace_back(
+		std::make_unique_for_overwrite<std::byte[]>(slot_stride * slots_per_block + SlotAlignment));
+	auto address = reinterpret_cast<uintptr_t>(block.get());
+	std::byte* first = block.get() + (SlotAlignment - address % SlotAlignment) % SlotAlignment;
+	free_slots.reserve(getSlotCount());
+	for (size_t i = slots_per_block; i-- > 0;)
+		free_slots.push_back(first + i * slot_stride);
+}
\ No newline at end of file
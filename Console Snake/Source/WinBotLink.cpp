@@ -0,0 +1,150 @@
+﻿#include "WinBotLink.h"
+#include "Exception.h"
+
+#include <utility>
+#include <cstdlib>
+
+namespace
+{
+	// time for the bot to exit by itself after the end of input
+	constexpr DWORD ExitWaitMilliseconds = 1000;
+	constexpr int CancelRetryMilliseconds = 10;
+} // namespace
+
+std::unique_ptr<WinBotLink> WinBotLink::Spawn(std::wstring command_line)
+{
+	SECURITY_ATTRIBUTES inheritable{ sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE };
+	HANDLE bot_input, to_bot, from_bot, bot_output;
+	if (!CreatePipe(&bot_input, &to_bot, &inheritable, 0))
+		throw RuntimeException(L"Cannot create the pipe of the bot.");
+	if (!CreatePipe(&from_bot, &bot_output, &inheritable, 0))
+	{
+		CloseHandle(bot_input);
+		CloseHandle(to_bot);
+		throw RuntimeException(L"Cannot create the pipe of the bot.");
+	}
+	// the child only inherits its own ends
+	SetHandleInformation(to_bot, HANDLE_FLAG_INHERIT, 0);
+	SetHandleInformation(from_bot, HANDLE_FLAG_INHERIT, 0);
+
+	STARTUPINFOW startup{};
+	startup.cb = sizeof(startup);
+	startup.dwFlags = STARTF_USESTDHANDLES;
+	startup.hStdInput = bot_input;
+	startup.hStdOutput = bot_output;
+	PROCESS_INFORMATION info{};
+	BOOL created = CreateProcessW(nullptr, command_line.data(), nullptr, nullptr, TRUE,
+								  CREATE_NO_WINDOW, nullptr, nullptr, &startup, &info);
+	CloseHandle(bot_input);
+	CloseHandle(bot_output);
+	if (!created)
+	{
+		CloseHandle(to_bot);
+		CloseHandle(from_bot);
+		throw RuntimeException(L"Cannot start the bot.");
+	}
+	CloseHandle(info.hThread);
+	return std::unique_ptr<WinBotLink>(new WinBotLink(info.hProcess, to_bot, from_bot));
+}
+
+WinBotLink::WinBotLink(HANDLE process, HANDLE to_bot, HANDLE from_bot)
+	: process(process), to_bot(to_bot), from_bot(from_bot)
+{
+	reader = std::thread(&WinBotLink::readBot, this);
+	writer = std::thread(&WinBotLink::writeBot, this);
+}
+
+WinBotLink::~WinBotLink() noexcept
+{
+	{
+		std::unique_lock lock(sending_mutex);
+		stopping = true;
+		sending_signal.notify_all();
+		// a write to a bot which doesn't read blocks, cancelled until the writer is out of it
+		while (writing)
+		{
+			CancelSynchronousIo(writer.native_handle());
+			sending_signal.wait_for(lock, std::chrono::milliseconds(CancelRetryMilliseconds));
+		}
+	}
+	writer.join();
+	CloseHandle(to_bot); // the bot reads the end of input
+	if (WaitForSingleObject(process, ExitWaitMilliseconds) != WAIT_OBJECT_0)
+		TerminateProcess(process, EXIT_FAILURE);
+	reader.join(); // reading fails once the bot has exited
+	CloseHandle(from_bot);
+	CloseHandle(process);
+}
+
+void WinBotLink::send(std::string_view data, std::chrono::steady_clock::time_point deadline)
+{
+	std::unique_lock lock(sending_mutex);
+	if (write_failed)
+		throw RuntimeException(L"The bot is gone.");
+	sending.append(data);
+	sending_signal.notify_all();
+	if (!sending_signal.wait_until(lock, deadline, [&] { return (sending.empty() && !writing) || write_failed; }))
+		throw RuntimeException(L"The bot doesn't take its input.");
+	if (write_failed)
+		throw RuntimeException(L"The bot is gone.");
+}
+
+bool WinBotLink::receive(std::string& buffer, std::chrono::steady_clock::time_point deadline)
+{
+	std::unique_lock lock(received_mutex);
+	if (!received_signal.wait_until(lock, deadline, [&] { return !received.empty() || closed; }))
+		return false;
+	if (received.empty())
+		throw RuntimeException(L"The bot is gone.");
+	buffer += received;
+	received.clear();
+	return true;
+}
+
+void WinBotLink::readBot() noexcept
+{
+	char data[4096];
+	DWORD count = 0;
+	while (ReadFile(from_bot, data, sizeof(data), &count, nullptr) && count != 0)
+	{
+		{
+			std::lock_guard lock(received_mutex);
+			received.append(data, count);
+		}
+		received_signal.notify_one();
+	}
+	{
+		std::lock_guard lock(received_mutex);
+		closed = true;
+	}
+	received_signal.notify_one();
+}
+
+void WinBotLink::writeBot() noexcept
+{
+	std::string data;
+	std::unique_lock lock(sending_mutex);
+	while (true)
+	{
+		sending_signal.wait(lock, [&] { return !sending.empty() || stopping; });
+		if (stopping)
+			return;
+		data.swap(sending);
+		writing = true;
+		lock.unlock();
+		bool failed = false;
+		for (std::string_view left = data; !left.empty() && !failed;)
+		{
+			DWORD written = 0;
+			failed = !WriteFile(to_bot, left.data(), static_cast<DWORD>(left.size()), &written, nullptr);
+			left.remove_prefix(written);
+		}
+		data.clear();
+		lock.lock();
+		writing = false;
+		write_failed = write_failed || failed;
+		sending_signal.notify_all();
+		if (failed)
+			return;
+	}
+}
\ No newline at end of file
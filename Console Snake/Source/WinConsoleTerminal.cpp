@@ -0,0 +1,109 @@
+﻿#include "WinConsoleTerminal.h"
+#include "VirtualTerminal.h"
+#include "ErrorHandling.h"
+
+#include <string>
+#include <cstdio>
+
+WinConsoleTerminal::WinConsoleTerminal(HANDLE output_handle, bool virtual_terminal) noexcept
+	: output_handle(output_handle), virtual_terminal(virtual_terminal)
+{
+
+}
+
+void WinConsoleTerminal::setColor(uint16_t attribute)
+{
+	if (current_color == attribute)
+		return;
+	if (virtual_terminal)
+	{
+		VirtualTerminal::AppendColor(buffer, attribute);
+	}
+	else
+	{
+		flush();
+		if (!SetConsoleTextAttribute(output_handle, attribute))
+			throw NativeException{};
+	}
+	current_color = attribute;
+}
+
+void WinConsoleTerminal::setCursor(short column, short row)
+{
+	if (virtual_terminal)
+	{
+		VirtualTerminal::AppendCursor(buffer, column, row);
+	}
+	else
+	{
+		flush();
+		if (!SetConsoleCursorPosition(output_handle, COORD{ column, row }))
+			throw NativeException{};
+	}
+}
+
+void WinConsoleTerminal::write(std::wstring_view str)
+{
+	buffer += str;
+}
+
+void WinConsoleTerminal::setCursorVisible(bool visible)
+{
+	flush();
+	CONSOLE_CURSOR_INFO cci;
+	if (!GetConsoleCursorInfo(output_handle, &cci))
+		throw NativeException{};
+	cci.bVisible = static_cast<BOOL>(visible);
+	if (!SetConsoleCursorInfo(output_handle, &cci))
+		throw NativeException{};
+}
+
+void WinConsoleTerminal::setTitle(std::wstring_view title)
+{
+	// may be called from timer threads, so never touch the buffer
+	if (!SetConsoleTitleW(std::wstring(title).c_str()))
+		throw NativeException{};
+}
+
+void WinConsoleTerminal::resize(short columns, short rows)
+{
+	try {
+		flush();
+	}
+	catch (const Exception&) {}
+	// shrink the window first, the screen buffer can't be smaller than it
+	SMALL_RECT window = { 0, 0, 0, 0 };
+	SetConsoleWindowInfo(output_handle, TRUE, &window);
+	SetConsoleScreenBufferSize(output_handle, COORD{ columns, rows });
+	window = { 0, 0, static_cast<SHORT>(columns - 1), static_cast<SHORT>(rows - 1) };
+	SetConsoleWindowInfo(output_handle, TRUE, &window);
+	clear();
+}
+
+void WinConsoleTerminal::clear()
+{
+	try {
+		flush();
+	}
+	catch (const Exception&) {}
+	CONSOLE_SCREEN_BUFFER_INFO info;
+	if (!GetConsoleScreenBufferInfo(output_handle, &info))
+		return;
+	DWORD count = info.dwSize.X * info.dwSize.Y;
+	DWORD written = 0;
+	FillConsoleOutputCharacterW(output_handle, L' ', count, COORD{ 0, 0 }, &written);
+	FillConsoleOutputAttribute(output_handle, info.wAttributes, count, COORD{ 0, 0 }, &written);
+	SetConsoleCursorPosition(output_handle, COORD{ 0, 0 });
+}
+
+void WinConsoleTerminal::flush()
+{
+	if (buffer.empty())
+		return;
+	fflush(stdout); // keep the order with the unbuffered printing
+	DWORD written = 0;
+	bool success = WriteConsoleW(output_handle, buffer.data(), static_cast<DWORD>(buffer.size()), &written, NULL);
+	buffer.clear();
+	if (!success)
+		throw NativeException{};
+}
\ No newline at end of file
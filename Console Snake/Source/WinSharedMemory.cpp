@@ -0,0 +1,67 @@
+﻿#include "SharedMemory.h"
+#include "Exception.h"
+
+#include <utility>
+#include "WinHeader.h"
+
+namespace
+{
+	// in the namespace of the session, which needs no privilege
+	std::wstring MappingName(const std::string& name)
+	{
+		return L"Local\\" + std::wstring(name.begin(), name.end());
+	}
+} // namespace
+
+std::unique_ptr<SharedMemory> SharedMemory::Create(const std::string& name, size_t size)
+{
+	// zero filled, and removed with the last handle
+	HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+									   static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+									   static_cast<DWORD>(size), MappingName(name).c_str());
+	if (mapping == nullptr)
+		throw RuntimeException(L"Cannot create the shared memory.");
+	void* address = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if (address == nullptr)
+	{
+		CloseHandle(mapping);
+		throw RuntimeException(L"Cannot map the shared memory.");
+	}
+	return std::unique_ptr<SharedMemory>(new SharedMemory(name, address, size, reinterpret_cast<intptr_t>(mapping), true));
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Open(const std::string& name)
+{
+	HANDLE mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, MappingName(name).c_str());
+	if (mapping == nullptr)
+		throw RuntimeException(L"Cannot open the shared memory.");
+	void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	MEMORY_BASIC_INFORMATION info{};
+	if (address == nullptr || VirtualQuery(address, &info, sizeof(info)) == 0)
+	{
+		if (address != nullptr)
+			UnmapViewOfFile(address);
+		CloseHandle(mapping);
+		throw RuntimeException(L"Cannot map the shared memory.");
+	}
+	// the size of the view, rounded up to pages, the header tells the size in use
+	return std::unique_ptr<SharedMemory>(new SharedMemory(name, address, info.RegionSize,
+														  reinterpret_cast<intptr_t>(mapping), false));
+}
+
+SharedMemory::SharedMemory(std::string name, void* address, size_t size, intptr_t handle, bool owner) noexcept
+	: name(std::move(name)), address(address), size(size), handle(handle), owner(owner)
+{
+
+}
+
+SharedMemory::~SharedMemory() noexcept
+{
+	UnmapViewOfFile(address);
+	CloseHandle(reinterpret_cast<HANDLE>(handle));
+}
+
+std::span<std::byte> SharedMemory::data() const noexcept
+{
+	return { static_cast<std::byte*>(address), size };
+}
\ No newline at end of file
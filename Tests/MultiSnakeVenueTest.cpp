@@ -0,0 +1,38 @@
+﻿#include "MultiSnakeVenue.h"
+#include "Pythonic.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+// Two snakes of one node moving into each other collide head-on, instead of
+// passing through each other because each head is the tail left in the tick.
+int main()
+{
+	// only the two nodes of the top row are free
+	DynArray<MapNode, 2> map(2, 2);
+	for (auto x : range(2))
+	{
+		map[0][x].type = Element::Blank;
+		map[1][x].type = Element::Barrier;
+	}
+	size_t games = 0;
+	for (uint64_t seed = 0; seed < 100; seed++)
+	{
+		MultiSnakeVenue venue(map, 0, seed);
+		auto first = venue.spawnSnake(1), second = venue.spawnSnake(1);
+		if (!first || !second)
+			continue; // no room found by random placement
+		// through either border, moving right and left reach the other node
+		venue.orderDirection(*first, Direction::Right);
+		venue.orderDirection(*second, Direction::Right);
+		auto result = venue.tick();
+		games++;
+		if (result.deaths != 2 || venue.getAliveCount() != 0)
+		{
+			std::fprintf(stderr, "seed %llu: %zu deaths, %zu alive\n",
+						 static_cast<unsigned long long>(seed), result.deaths, venue.getAliveCount());
+			return EXIT_FAILURE;
+		}
+	}
+	return games != 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
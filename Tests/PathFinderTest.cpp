@@ -0,0 +1,93 @@
+﻿#include "PathFinder.h"
+#include "HeadlessVenue.h"
+#include "FastRandom.h"
+#include "Exception.h"
+#include "Pythonic.h"
+
+#include <vector>
+#include <optional>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+	bool IsPassable(const Venue& venue, PosNode pos)
+	{
+		auto type = venue.getPositionType(pos.x, pos.y);
+		return type == Element::Blank || type == Element::Food;
+	}
+}
+
+// The paths of A* are as long as the distances of the breadth-first search, and lead
+// through passable nodes to the target. The areas flooded match the nodes reached.
+int main()
+{
+	constexpr size_t Size = 16;
+	FastRandom random(1);
+	PathFinder path_finder;
+	size_t paths = 0;
+	for (auto round : range<size_t>(50))
+	{
+		// the snake is placed on a map with a quarter of barriers, if it finds room
+		DynArray<MapNode, 2> map(Size, Size);
+		for (auto& node : map.iter_all())
+			node.type = random.bounded(4) == 0 ? Element::Barrier : Element::Blank;
+		std::optional<HeadlessVenue> venue;
+		try {
+			venue.emplace(map, random());
+		}
+		catch (const Exception&) {
+			continue;
+		}
+
+		std::vector<PosNode> sources{ venue->getSnakeHead() };
+		for ([[maybe_unused]] auto i : range(8))
+			sources.push_back({ random.between<uint8_t>(0, Size - 1), random.between<uint8_t>(0, Size - 1) });
+		for (auto from : sources)
+		{
+			path_finder.measureFrom(*venue, from);
+			std::vector<uint32_t> distances;
+			size_t reached = 0;
+			for (auto y : range<uint8_t>(Size))
+				for (auto x : range<uint8_t>(Size))
+				{
+					distances.push_back(path_finder.getDistance({ x, y }));
+					reached += distances.back() != PathFinder::Unreachable;
+				}
+			if (IsPassable(*venue, from) && path_finder.countReachable(*venue, from) != reached)
+			{
+				std::fprintf(stderr, "round %zu: %zu reachable, %zu reached\n", round,
+							 path_finder.countReachable(*venue, from), reached);
+				return EXIT_FAILURE;
+			}
+
+			for (auto y : range<uint8_t>(Size))
+				for (auto x : range<uint8_t>(Size))
+				{
+					PosNode to{ x, y };
+					if (to == from)
+						continue;
+					auto distance = distances[y * Size + x];
+					auto path = path_finder.findPath(*venue, from, to);
+					bool leads_to = true;
+					PosNode pos = from;
+					for (auto direct : path)
+					{
+						pos = venue->getAdjacentPosition(pos, direct);
+						leads_to = leads_to && IsPassable(*venue, pos);
+					}
+					leads_to = leads_to && pos == to;
+					bool expected = distance == PathFinder::Unreachable
+						? path.empty() : path.size() == distance && leads_to;
+					if (!expected)
+					{
+						std::fprintf(stderr, "round %zu: path of %zu steps from %d %d to %d %d, distance %u\n",
+									 round, path.size(), from.x, from.y, to.x, to.y, distance);
+						return EXIT_FAILURE;
+					}
+					paths += !path.empty();
+				}
+		}
+	}
+	return paths != 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
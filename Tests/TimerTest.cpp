@@ -0,0 +1,34 @@
+﻿#include "Timer.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+
+// A one-shot Timer destroyed while its f() runs: the destructor waits for f(),
+// and the callback runs exactly once, on the worker which erased the slot.
+int main()
+{
+	using namespace std::chrono_literals;
+	for (int round = 0; round < 20; round++)
+	{
+		std::atomic<bool> running = false;
+		std::atomic<int> callbacks = 0;
+		{
+			Timer timer([&] { running = true; std::this_thread::sleep_for(20ms); }, 1ms,
+						Timer::NoLoop, [&] { callbacks++; });
+			while (!running)
+				std::this_thread::yield();
+		}
+		// the callback of the worker may come after the destructor returns
+		for (int wait = 0; wait < 100 && callbacks == 0; wait++)
+			std::this_thread::sleep_for(1ms);
+		if (callbacks != 1)
+		{
+			std::fprintf(stderr, "round %d: %d callbacks\n", round, callbacks.load());
+			return EXIT_FAILURE;
+		}
+	}
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
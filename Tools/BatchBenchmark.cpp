@@ -0,0 +1,80 @@
+﻿#include "VenueBatch.h"
+#include "HeadlessVenue.h"
+#include "FastRandom.h"
+#include "ToolMaps.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <span>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cwchar>
+
+namespace
+{
+	constexpr Direction::Tags Candidates[] =
+	{ Direction::None, Direction::Up, Direction::Left, Direction::Right, Direction::Down };
+	// action vectors are reused in turn, so that drawing them isn't measured
+	constexpr size_t ActionRounds = 64;
+
+	template<typename Step>
+	void Measure(const wchar_t* name, size_t steps, std::span<const std::vector<Direction>> actions, Step step)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < steps; i++)
+			step(actions[i % actions.size()]);
+		std::chrono::duration<double> time = std::chrono::steady_clock::now() - begin;
+		std::wprintf(L"%-24ls %14.0f env-steps/s\n", name, steps * actions[0].size() / time.count());
+	}
+} // namespace
+
+// Env-steps per second of K games stepped in lockstep with random actions,
+// one HeadlessVenue per game against VenueBatch on one and on all threads.
+// usage: SnakeBatchBenchmark [batch size] [steps] [threads] [map size] [Square|Space] [seed]
+int main(int argc, char* argv[])
+{
+	size_t batch_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+	size_t steps = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+	size_t thread_count = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0;
+	size_t size = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 15;
+	std::wstring map_name = argc > 5 && std::string(argv[5]) == "Square" ? L"Square" : L"Space";
+	uint64_t seed = argc > 6 ? std::strtoull(argv[6], nullptr, 10) : 1;
+	auto map = MakeToolMap(map_name, size);
+
+	FastRandom random(seed);
+	std::vector<std::vector<Direction>> actions(ActionRounds, std::vector<Direction>(batch_size));
+	for (auto& round : actions)
+		for (auto& action : round)
+			action = Candidates[random.bounded(5)];
+
+	std::wprintf(L"%ls %zux%zu, %zu games, %zu steps\n", map_name.c_str(), size, size, batch_size, steps);
+	{
+		std::vector<std::unique_ptr<HeadlessVenue>> venues;
+		for (size_t game = 0; game < batch_size; game++)
+			venues.push_back(std::make_unique<HeadlessVenue>(map, seed + game));
+		uint64_t next_seed = seed + batch_size;
+		Measure(L"HeadlessVenue per game", steps, actions, [&](const std::vector<Direction>& round)
+			{
+				for (size_t game = 0; game < batch_size; game++)
+				{
+					venues[game]->step(round[game]);
+					if (venues[game]->isOver())
+						venues[game] = std::make_unique<HeadlessVenue>(map, next_seed++);
+				}
+			});
+	}
+	{
+		VenueBatch batch(map, batch_size, seed);
+		Measure(L"VenueBatch", steps, actions, [&](const std::vector<Direction>& round) { batch.step(round); });
+	}
+	{
+		VenueBatch batch(map, batch_size, seed);
+		VenueBatchThreads threads(batch, thread_count);
+		std::wstring name = L"VenueBatch, " + std::to_wstring(threads.getThreadCount()) + L" threads";
+		Measure(name.c_str(), steps, actions, [&](const std::vector<Direction>& round) { threads.step(round); });
+	}
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+﻿#include "BotSession.h"
+#include "PosixBotLink.h"
+#include "HeadlessVenue.h"
+#include "FrameScheduler.h"
+#include "ToolMaps.h"
+#include "Random.h"
+#include "Exception.h"
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cwchar>
+
+// usage:
+//     SnakeBotMatch [frames per second] [deadline ms] [map size] [Square|Space] [seed] -- <bot command...>
+//     SnakeBotMatch [...] -- unix:<socket path>
+// Plays a game by the bot, paced like the game (frames per second 0: as fast as the bot replies),
+// and reports the score and how long the game waited for replies.
+int main(int argc, char* argv[]) try
+{
+	int separator = 1;
+	while (separator < argc && std::string(argv[separator]) != "--")
+		separator++;
+	if (separator + 1 >= argc)
+	{
+		std::fwprintf(stderr, L"usage: SnakeBotMatch [frames per second] [deadline ms] [map size] [Square|Space] [seed] -- <bot command...>\n");
+		return EXIT_FAILURE;
+	}
+	auto option = [&](int index) -> const char* { return index < separator ? argv[index] : nullptr; };
+	double frames_per_second = option(1) ? std::strtod(option(1), nullptr) : 33.0; // speed 10
+	auto deadline = std::chrono::milliseconds(option(2) ? std::strtoull(option(2), nullptr, 10) : 30);
+	size_t size = option(3) ? std::strtoull(option(3), nullptr, 10) : 15;
+	std::wstring map_name = option(4) && std::string(option(4)) == "Square" ? L"Square" : L"Space";
+	uint64_t seed = option(5) ? std::strtoull(option(5), nullptr, 10) : GetRandomSeed();
+
+	std::span<char* const> command(argv + separator + 1, argv + argc);
+	std::string target = command[0];
+	BotSession bot(target.starts_with("unix:")
+				   ? PosixBotLink::Connect(target.substr(5))
+				   : PosixBotLink::Spawn(command), deadline);
+	HeadlessVenue venue(MakeToolMap(map_name, size), seed);
+	bot.start(venue);
+
+	std::optional<FrameScheduler> scheduler;
+	if (frames_per_second > 0)
+		scheduler.emplace(std::chrono::duration_cast<FrameScheduler::Clock::duration>(
+			std::chrono::duration<double>(1.0 / frames_per_second)));
+	auto begin = std::chrono::steady_clock::now();
+	for (size_t stalled = 0, score = 0; !venue.isOver() && stalled < size * size * 4 && bot.isConnected(); stalled++)
+	{
+		if (scheduler)
+			scheduler->wait(); // frames are never caught up, the bot plays every one
+		auto frame = venue.step(bot.awaitMove());
+		if (frame.count != 0)
+			bot.sendFrame(venue, frame);
+		if (venue.getScore() != score)
+			score = venue.getScore(), stalled = 0;
+	}
+	bot.finish(venue.getScore(), venue.isWin());
+	std::chrono::duration<double> time = std::chrono::steady_clock::now() - begin;
+
+	auto& stats = bot.getStats();
+	std::wprintf(L"score %zu%ls in %zu frames, %.1f s\n", venue.getScore(), venue.isWin() ? L" (win)" : L"",
+				 venue.getTicks(), time.count());
+	std::wprintf(L"%zu moves, %zu late, waited %.1f us on average and %lld us at most%ls\n",
+				 stats.moves, stats.late, stats.moves ? double(stats.total_wait.count()) / stats.moves : 0.0,
+				 static_cast<long long>(stats.max_wait.count()), bot.isConnected() ? L"" : L", the bot is gone");
+	if (scheduler)
+	{
+		// frames the bot made late, as FrameScheduler sees them
+		auto pacing = scheduler->getStats();
+		std::wprintf(L"%zu frames late, %zu dropped, %lld us behind at most\n", pacing.late_frames,
+					 pacing.dropped_frames, static_cast<long long>(
+						 std::chrono::duration_cast<std::chrono::microseconds>(pacing.max_overshoot).count()));
+	}
+	return EXIT_SUCCESS;
+}
+catch (const Exception& error)
+{
+	std::fwprintf(stderr, L"%ls\n", error.what());
+	return EXIT_FAILURE;
+}
\ No newline at end of file
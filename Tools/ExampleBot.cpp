@@ -0,0 +1,223 @@
+﻿#include <deque>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+// A bot for SnakeBotMatch and the -bot option of the game, see BotSession.h for the protocol.
+// Takes the shortest path to the food if the room after it is no less than the snake,
+// otherwise the move with the most room. Only uses the standard library, as bots in other
+// languages would do.
+namespace
+{
+	struct Node
+	{
+		int x;
+		int y;
+	};
+
+	class Board
+	{
+	public:
+		void reset(int height, int width, const std::string& cells)
+		{
+			this->height = height;
+			this->width = width;
+			this->cells = cells;
+			snake.clear();
+		}
+
+		// nodes from the head to the tail
+		void place(const std::vector<Node>& nodes, Node food)
+		{
+			for (auto node : nodes)
+			{
+				at(node) = 'S';
+				snake.push_back(node);
+			}
+			setFood(food);
+		}
+
+		void move(Node head, Node left_tail, Node food)
+		{
+			at(head) = 'S';
+			snake.push_front(head);
+			if (left_tail.x >= 0)
+			{
+				at(left_tail) = '.';
+				snake.pop_back();
+			}
+			setFood(food);
+		}
+
+		char choose()
+		{
+			static constexpr char Letters[] = { 'U', 'D', 'L', 'R' };
+			Node head = snake.front();
+			// shortest path to the food, by the first move of it
+			std::vector<int> first(cells.size(), -1);
+			std::deque<Node> frontier;
+			for (int i = 0; i < 4; i++)
+			{
+				Node next = step(head, i);
+				if (isFree(next) && first[index(next)] < 0)
+				{
+					first[index(next)] = i;
+					frontier.push_back(next);
+				}
+			}
+			int food_move = -1;
+			while (!frontier.empty() && food_move < 0)
+			{
+				Node node = frontier.front();
+				frontier.pop_front();
+				if (at(node) == 'F')
+					food_move = first[index(node)];
+				for (int i = 0; i < 4; i++)
+				{
+					Node next = step(node, i);
+					if (isFree(next) && first[index(next)] < 0)
+					{
+						first[index(next)] = first[index(node)];
+						frontier.push_back(next);
+					}
+				}
+			}
+			if (food_move >= 0 && room(step(head, food_move)) >= snake.size())
+				return Letters[food_move];
+			int best = -1;
+			size_t best_room = 0;
+			for (int i = 0; i < 4; i++)
+			{
+				Node next = step(head, i);
+				if (!isFree(next))
+					continue;
+				size_t next_room = room(next);
+				if (best < 0 || next_room > best_room)
+					best = i, best_room = next_room;
+			}
+			return best < 0 ? 'N' : Letters[best];
+		}
+
+	private:
+		void setFood(Node food)
+		{
+			if (food.x >= 0)
+				at(food) = 'F';
+		}
+
+		size_t room(Node from)
+		{
+			std::vector<bool> seen(cells.size());
+			std::vector<Node> stack{ from };
+			seen[index(from)] = true;
+			size_t count = 0;
+			while (!stack.empty())
+			{
+				Node node = stack.back();
+				stack.pop_back();
+				count++;
+				for (int i = 0; i < 4; i++)
+				{
+					Node next = step(node, i);
+					if (isFree(next) && !seen[index(next)])
+					{
+						seen[index(next)] = true;
+						stack.push_back(next);
+					}
+				}
+			}
+			return count;
+		}
+
+		// the tail is free, it leaves before the head comes unless the snake grows
+		bool isFree(Node node)
+		{
+			char cell = at(node);
+			return cell == '.' || cell == 'F' || (snake.size() > 1 &&
+				node.x == snake.back().x && node.y == snake.back().y);
+		}
+
+		Node step(Node node, int direction) const
+		{
+			switch (direction)
+			{
+				case 0:
+					return { node.x, (node.y + height - 1) % height };
+				case 1:
+					return { node.x, (node.y + 1) % height };
+				case 2:
+					return { (node.x + width - 1) % width, node.y };
+				default:
+					return { (node.x + 1) % width, node.y };
+			}
+		}
+
+		size_t index(Node node) const
+		{
+			return static_cast<size_t>(node.y) * width + node.x;
+		}
+
+		char& at(Node node)
+		{
+			return cells[index(node)];
+		}
+
+	private:
+		int height = 0;
+		int width = 0;
+		std::string cells;
+		std::deque<Node> snake;
+	};
+} // namespace
+
+int main()
+{
+	std::ios::sync_with_stdio(false);
+	Board board;
+	int height = 0, width = 0;
+	std::string line, word;
+	while (std::getline(std::cin, line))
+	{
+		std::istringstream message(line);
+		message >> word;
+		if (word == "snake")
+		{
+			int version;
+			message >> version >> height >> width;
+		}
+		else if (word == "map")
+		{
+			std::string cells;
+			message >> cells;
+			board.reset(height, width, cells);
+		}
+		else if (word == "start")
+		{
+			char direction;
+			Node food;
+			size_t length;
+			message >> direction >> food.x >> food.y >> length;
+			std::vector<Node> nodes(length);
+			for (auto& node : nodes)
+				message >> node.x >> node.y;
+			board.place(nodes, food);
+			std::cout << "0 " << board.choose() << std::endl;
+		}
+		else if (word == "frame")
+		{
+			long long frame;
+			Node head, left_tail, food;
+			message >> frame >> head.x >> head.y >> left_tail.x >> left_tail.y >> food.x >> food.y;
+			board.move(head, left_tail, food);
+			std::cout << frame << ' ' << board.choose() << std::endl;
+		}
+		else if (word == "over")
+		{
+			return EXIT_SUCCESS;
+		}
+	}
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+﻿#include "FrameExport.h"
+#include "HeadlessVenue.h"
+#include "Solver.h"
+#include "FrameBuffer.h"
+#include "FrameScheduler.h"
+#include "AnsiTerminal.h"
+#include "ToolMaps.h"
+#include "Random.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cwchar>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// usage:
+//     SnakeFrames publish <name> [frames per second] [map size] [Square|Space] [seed]
+//         play a game of GreedySolver, published as the game does with -export
+//     SnakeFrames watch <name> [frames per second]   render the frames published to the terminal
+//     SnakeFrames stress <name> [readers] [seconds]
+//         publish as fast as possible while reader processes check every frame they copy,
+//         and report the time the writer spends per frame
+namespace
+{
+	std::chrono::steady_clock::duration FrameInterval(double frames_per_second)
+	{
+		return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(1.0 / frames_per_second));
+	}
+
+	int Publish(const std::string& name, double frames_per_second, size_t size,
+				std::wstring_view map_name, uint64_t seed)
+	{
+		HeadlessVenue venue(MakeToolMap(map_name, size), seed);
+		FrameExporter exporter(name, venue);
+		GreedySolver solver;
+		std::optional<FrameScheduler> scheduler;
+		if (frames_per_second > 0)
+			scheduler.emplace(FrameInterval(frames_per_second));
+		for (size_t stalled = 0, score = 0; !venue.isOver() && stalled < size * size * 4; stalled++)
+		{
+			if (scheduler)
+				scheduler->wait();
+			auto frame = venue.step(solver.solveNextStep(venue));
+			exporter.publish(venue, frame, venue.getScore(), venue.isWin());
+			if (venue.getScore() != score)
+				score = venue.getScore(), stalled = 0;
+		}
+		std::wprintf(L"%zu frames, score %zu\n", venue.getTicks(), venue.getScore());
+		return EXIT_SUCCESS;
+	}
+
+	int Watch(const std::string& name, double frames_per_second)
+	{
+		FrameReader reader(name);
+		const size_t height = reader.getHeight(), width = reader.getWidth();
+		FrameBuffer buffer(width * 2, height);
+		AnsiTerminal terminal;
+		terminal.setCursorVisible(false);
+		terminal.clear();
+		FrameScheduler scheduler(FrameInterval(frames_per_second));
+
+		SharedFrame frame;
+		std::wstring text;
+		uint64_t sequence = 0;
+		do
+		{
+			scheduler.wait(); // frames published in between are skipped
+			if (reader.getSequence() == sequence)
+				continue;
+			sequence = reader.read(frame);
+			for (size_t y = 0; y < height; y++)
+				for (size_t x = 0; x < width; x++)
+					DrawElementCell(buffer, x, y, frame.nodes[y * width + x]);
+			buffer.present(
+				[&](size_t x, size_t y, std::span<const FrameCell> cells)
+				{
+					terminal.setCursor(static_cast<short>(x), static_cast<short>(y));
+					for (auto& cell : cells)
+					{
+						terminal.setColor(cell.color);
+						terminal.write(std::wstring_view(&cell.glyph, 1));
+					}
+				});
+			terminal.setColor(0x07);
+			terminal.setCursor(0, static_cast<short>(height));
+			text = L"frame " + std::to_wstring(frame.frame) + L"  score " + std::to_wstring(frame.score);
+			terminal.write(text);
+			terminal.flush();
+		} while (!frame.over && !frame.closed);
+		terminal.setCursorVisible(true);
+		terminal.write(L"\n");
+		return EXIT_SUCCESS;
+	}
+
+	// The nodes agree with the fields, and copies never go back to older frames.
+	// Each game is a new segment, mapped again once the last one is closed.
+	int CheckFrames(const std::string& name, std::chrono::steady_clock::time_point end)
+	{
+		std::optional<FrameReader> reader;
+		SharedFrame frame;
+		size_t reads = 0, torn = 0, games = 0;
+		uint64_t last_sequence = 0;
+		while (std::chrono::steady_clock::now() < end)
+		{
+			if (!reader)
+			{
+				try {
+					reader.emplace(name);
+				}
+				catch (const Exception&) {
+					continue; // the segment of the next game isn't there yet
+				}
+				last_sequence = 0;
+				games++;
+			}
+			uint64_t sequence = reader->read(frame);
+			auto snake = std::count(frame.nodes.begin(), frame.nodes.end(), Element::Snake);
+			auto food = std::count(frame.nodes.begin(), frame.nodes.end(), Element::Food);
+			if (static_cast<size_t>(snake) != frame.snake_length || food > 1
+				|| sequence % 2 == 1 || sequence < last_sequence)
+				torn++;
+			last_sequence = sequence;
+			reads++;
+			if (frame.closed)
+				reader.reset();
+		}
+		std::wprintf(L"reader %d: %zu reads of %zu segments, %zu inconsistent\n", static_cast<int>(getpid()),
+					 reads, games, torn);
+		std::fflush(stdout); // left by _Exit()
+		return torn == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	int Stress(const std::string& name, size_t readers, double seconds)
+	{
+		constexpr size_t Size = 24;
+		uint64_t seed = GetRandomSeed();
+		HeadlessVenue venue(MakeToolMap(L"Space", Size), seed);
+		std::optional<FrameExporter> exporter(std::in_place, name, venue);
+		GreedySolver solver;
+		auto end = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(seconds));
+		std::vector<pid_t> children;
+		for (size_t i = 0; i < readers; i++)
+			if (pid_t child = fork(); child == 0)
+				std::_Exit(CheckFrames(name, end));
+			else if (child > 0)
+				children.push_back(child);
+
+		size_t frames = 0, games = 1;
+		std::chrono::steady_clock::duration writing{};
+		while (std::chrono::steady_clock::now() < end)
+		{
+			if (venue.isOver() || venue.getTicks() > Size * Size * 16)
+			{
+				venue = HeadlessVenue(MakeToolMap(L"Space", Size), ++seed);
+				exporter.reset(); // closes the segment of the last game first
+				exporter.emplace(name, venue);
+				games++;
+			}
+			auto frame = venue.step(solver.solveNextStep(venue));
+			auto begin = std::chrono::steady_clock::now();
+			exporter->publish(venue, frame, venue.getScore(), venue.isWin());
+			writing += std::chrono::steady_clock::now() - begin;
+			frames++;
+		}
+		bool consistent = true;
+		for (pid_t child : children)
+		{
+			int status = 0;
+			waitpid(child, &status, 0);
+			consistent = consistent && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+		}
+		std::wprintf(L"%zu readers, %zu frames in %zu games, %.0f ns per frame published (with the clock)\n",
+					 children.size(), frames, games,
+					 std::chrono::duration<double, std::nano>(writing).count() / static_cast<double>(frames));
+		return consistent ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+}
+
+int main(int argc, char* argv[]) try
+{
+	std::string command = argc > 1 ? argv[1] : "";
+	if (argc < 3 || (command != "publish" && command != "watch" && command != "stress"))
+	{
+		std::fwprintf(stderr, L"usage: SnakeFrames publish|watch|stress <name> [...]\n");
+		return EXIT_FAILURE;
+	}
+	std::string name = argv[2];
+	if (command == "publish")
+	{
+		double frames_per_second = argc > 3 ? std::strtod(argv[3], nullptr) : 10.0;
+		size_t size = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 15;
+		std::wstring map_name = argc > 5 && std::string(argv[5]) == "Space" ? L"Space" : L"Square";
+		uint64_t seed = argc > 6 ? std::strtoull(argv[6], nullptr, 10) : GetRandomSeed();
+		return Publish(name, frames_per_second, size, map_name, seed);
+	}
+	if (command == "watch")
+	{
+		double frames_per_second = argc > 3 ? std::strtod(argv[3], nullptr) : 30.0;
+		return Watch(name, frames_per_second > 0 ? frames_per_second : 30.0);
+	}
+	size_t readers = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 4;
+	double seconds = argc > 4 ? std::strtod(argv[4], nullptr) : 2.0;
+	return Stress(name, readers, seconds > 0 ? seconds : 2.0);
+}
+catch (const Exception& error)
+{
+	std::fwprintf(stderr, L"%ls\n", error.what());
+	return EXIT_FAILURE;
+}
\ No newline at end of file
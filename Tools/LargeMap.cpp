@@ -0,0 +1,168 @@
+﻿#include "LargeVenue.h"
+#include "Viewport.h"
+#include "FrameBuffer.h"
+#include "FrameScheduler.h"
+#include "AnsiTerminal.h"
+#include "Random.h"
+#include "Exception.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cwchar>
+
+// usage:
+//     SnakeLargeMap bench [map size] [ticks] [Square|Space] [seed]   play headless, report speed and memory
+//     SnakeLargeMap play [map size] [frames per second] [Square|Space] [seed]   render a viewport
+namespace
+{
+	constexpr Direction::Tags Candidates[] =
+	{ Direction::Up, Direction::Left, Direction::Right, Direction::Down };
+
+	std::vector<LargeVenue::Rect> MakeBarriers(std::wstring_view name, size_t size)
+	{
+		if (name != L"Square")
+			return {};
+		return {
+			{ 0, 0, size, 1 },
+			{ 0, size - 1, size, 1 },
+			{ 0, 0, 1, size },
+			{ size - 1, 0, 1, size },
+		};
+	}
+
+	// negative if backwards, the shorter way on a ring if it wraps
+	long long AxisOffset(size_t from, size_t to, size_t size, bool wraps)
+	{
+		long long offset = static_cast<long long>(to) - static_cast<long long>(from);
+		long long half = static_cast<long long>(size / 2);
+		if (!wraps)
+			return offset;
+		if (offset > half)
+			offset -= size;
+		else if (offset < -half)
+			offset += size;
+		return offset;
+	}
+
+	// Head for the food, through the borders if they are open, avoiding the nodes next to the head.
+	Direction ChooseDirection(const LargeVenue& venue, bool wraps)
+	{
+		auto head = venue.getSnakeHead();
+		long long dx = 0, dy = 0;
+		if (auto food = venue.getFoodPosition())
+		{
+			dx = AxisOffset(head.x, food->x, venue.getWidth(), wraps);
+			dy = AxisOffset(head.y, food->y, venue.getHeight(), wraps);
+		}
+		Direction best = Direction::None;
+		long long best_gain = -1;
+		for (Direction direct : Candidates)
+		{
+			if (direct.isConflictWith(venue.getSnakeDirection()))
+				continue;
+			auto type = venue.getPositionType(venue.getAdjacentPosition(head, direct));
+			if (type == Element::Barrier || type == Element::Snake)
+				continue;
+			long long gain =
+				direct == Direction::Up ? -dy : direct == Direction::Down ? dy :
+				direct == Direction::Left ? -dx : dx;
+			if (best == Direction::None || gain > best_gain)
+				best = direct, best_gain = gain;
+		}
+		return best;
+	}
+
+	int Bench(size_t size, size_t ticks, std::wstring_view map_name, uint64_t seed)
+	{
+		auto barriers = MakeBarriers(map_name, size);
+		LargeVenue venue(size, size, barriers, seed);
+		auto begin = std::chrono::steady_clock::now();
+		while (!venue.isOver() && venue.getTicks() < ticks)
+			venue.step(ChooseDirection(venue, barriers.empty()));
+		std::chrono::duration<double> time = std::chrono::steady_clock::now() - begin;
+
+		size_t dense_bytes = size * size * sizeof(MapNode);
+		std::wprintf(L"%ls %zux%zu: %zu ticks, score %zu, %.0f ticks/s\n", map_name.data(), size, size,
+					 venue.getTicks(), venue.getScore(), venue.getTicks() / time.count());
+		std::wprintf(L"%zu tiles, %zu KiB (a dense map of MapNode: %zu KiB)\n",
+					 venue.getChunkCount(), venue.getMemoryUsage() / 1024, dense_bytes / 1024);
+		return EXIT_SUCCESS;
+	}
+
+	int Play(size_t size, double frames_per_second, std::wstring_view map_name, uint64_t seed)
+	{
+		constexpr size_t ViewHeight = 24, ViewWidth = 40, Margin = 6;
+		auto barriers = MakeBarriers(map_name, size);
+		LargeVenue venue(size, size, barriers, seed);
+		BasicViewport<uint16_t> viewport(size, size, ViewHeight, ViewWidth, Margin);
+		viewport.center(venue.getSnakeHead());
+		FrameBuffer frame(viewport.width() * 2, viewport.height());
+		AnsiTerminal terminal;
+		terminal.setCursorVisible(false);
+		terminal.clear();
+		FrameScheduler scheduler(std::chrono::duration_cast<FrameScheduler::Clock::duration>(
+			std::chrono::duration<double>(1.0 / frames_per_second)));
+
+		std::wstring text;
+		auto present = [&]
+			{
+				viewport.follow(venue.getSnakeHead());
+				viewport.draw(frame, [&](LargeVenue::Position pos) { return venue.getPositionType(pos); });
+				frame.present(
+					[&](size_t x, size_t y, std::span<const FrameCell> cells)
+					{
+						terminal.setCursor(static_cast<short>(x), static_cast<short>(y));
+						for (auto& cell : cells)
+						{
+							terminal.setColor(cell.color);
+							terminal.write(std::wstring_view(&cell.glyph, 1));
+						}
+					});
+				auto origin = viewport.getOrigin();
+				terminal.setColor(0x07);
+				terminal.setCursor(0, static_cast<short>(viewport.height()));
+				text = L"view " + std::to_wstring(origin.x) + L"," + std::to_wstring(origin.y) +
+					L"  score " + std::to_wstring(venue.getScore()) +
+					L"  tiles " + std::to_wstring(venue.getChunkCount()) + L"    ";
+				terminal.write(text);
+				terminal.flush();
+			};
+		present();
+		scheduler.restart();
+		while (!venue.isOver())
+		{
+			for (size_t due = scheduler.wait(); due != 0 && !venue.isOver(); due--)
+				venue.step(ChooseDirection(venue, barriers.empty()));
+			present();
+		}
+		terminal.setCursorVisible(true);
+		terminal.write(L"\n");
+		return EXIT_SUCCESS;
+	}
+}
+
+int main(int argc, char* argv[]) try
+{
+	std::string command = argc > 1 ? argv[1] : "";
+	if (command != "bench" && command != "play")
+	{
+		std::fwprintf(stderr, L"usage: SnakeLargeMap bench|play [...]\n");
+		return EXIT_FAILURE;
+	}
+	size_t size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4096;
+	std::wstring map_name = argc > 4 && std::string(argv[4]) == "Square" ? L"Square" : L"Space";
+	uint64_t seed = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : GetRandomSeed();
+	if (command == "bench")
+		return Bench(size, argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 10000000, map_name, seed);
+	double frames_per_second = argc > 3 ? std::strtod(argv[3], nullptr) : 30.0;
+	return Play(size, frames_per_second > 0 ? frames_per_second : 30.0, map_name, seed);
+}
+catch (const Exception& error)
+{
+	std::fwprintf(stderr, L"%ls\n", error.what());
+	return EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+﻿#include "Random.h"
+#include "FastRandom.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cwchar>
+
+// Throughput of picking the food index in the free segment of the snake ring,
+// as Venue::generateFood() does while the snake grows from 1 to the whole map.
+// usage: SnakeRandomBenchmark [map size] [rounds]
+namespace
+{
+	// GetRandom() as it was before the engines became thread_local, the baseline:
+	// one static engine and distribution shared by the whole process
+	size_t SharedGetRandom(size_t min, size_t max)
+	{
+		static std::default_random_engine engine(std::random_device{}());
+		static std::uniform_int_distribution<size_t> dis;
+		using param_type = decltype(dis)::param_type;
+		return dis(engine, param_type{ min, max });
+	}
+
+	template<typename Pick>
+	void Measure(const wchar_t* name, size_t cells, size_t rounds, Pick pick)
+	{
+		uint64_t sink = 0;
+		auto begin = std::chrono::steady_clock::now();
+		for (size_t round = 0; round < rounds; round++)
+			for (size_t range = cells; range != 0; range--)
+				sink += pick(range);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+		double picks = static_cast<double>(cells) * rounds;
+		std::wprintf(L"%-24ls %10.2f Mpicks/s %8.2f ns/pick (sink %llu)\n", name,
+					 picks / elapsed.count() / 1e6, elapsed.count() * 1e9 / picks,
+					 static_cast<unsigned long long>(sink & 0xFF));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	size_t size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 24;
+	size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+	size_t cells = size * size;
+
+	std::wprintf(L"%zux%zu map, %zu rounds\n", size, size, rounds);
+	Measure(L"GetRandom (static)", cells, rounds,
+			[](size_t range) { return SharedGetRandom(1, range); });
+	Measure(L"GetRandom (thread_local)", cells, rounds,
+			[](size_t range) { return GetRandom(1, range); });
+	FastRandom engine(GetRandomSeed());
+	Measure(L"FastRandom::between", cells, rounds,
+			[&](size_t range) { return engine.between<size_t>(1, range); });
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
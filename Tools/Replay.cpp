@@ -0,0 +1,180 @@
+﻿#include "Replay.h"
+#include "Solver.h"
+#include "FrameBuffer.h"
+#include "FrameScheduler.h"
+#include "AnsiTerminal.h"
+#include "ToolMaps.h"
+#include "Random.h"
+#include "Exception.h"
+
+#include <chrono>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cwchar>
+
+// usage:
+//     SnakeReplay record <file> [map size] [Square|Space] [seed]   record a game of GreedySolver
+//     SnakeReplay bench <file>                                    re-simulate as fast as possible
+//     SnakeReplay play <file> [frames per second]                  render to the terminal
+//     SnakeReplay states <files...>                                count distinct states in replays
+namespace
+{
+	Replay LoadReplay(const char* path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			throw RuntimeException(L"Cannot open the replay.");
+		return Replay::Load(file);
+	}
+
+	int Record(const char* path, size_t size, std::wstring_view map_name, uint64_t seed)
+	{
+		HeadlessVenue venue(MakeToolMap(map_name, size), seed);
+		ReplayRecorder recorder(MakeToolMap(map_name, size), seed);
+		GreedySolver solver;
+		for (size_t stalled = 0, score = 0; !venue.isOver() && stalled < size * size * 4; stalled++)
+		{
+			Direction input = solver.solveNextStep(venue);
+			recorder.record(input);
+			venue.step(input);
+			if (venue.getScore() != score)
+				score = venue.getScore(), stalled = 0;
+		}
+		std::ofstream file(path, std::ios::binary);
+		recorder.getReplay().save(file);
+		std::wprintf(L"%zu frames in %zu runs, score %zu\n", venue.getTicks(),
+					 recorder.getReplay().runs.size(), venue.getScore());
+		return EXIT_SUCCESS;
+	}
+
+	int Bench(const Replay& replay)
+	{
+		// for a second each, play() returns the frames played
+		auto measure = [](const wchar_t* venue, auto play)
+			{
+				size_t frames = 0, plays = 0;
+				auto begin = std::chrono::steady_clock::now();
+				std::chrono::duration<double> elapsed{};
+				for (; elapsed.count() < 1.0; plays++)
+				{
+					frames += play();
+					elapsed = std::chrono::steady_clock::now() - begin;
+				}
+				std::wprintf(L"%-18ls %zu frames per play, %zu plays, %.0f frames/s\n",
+							 venue, frames / plays, plays, frames / elapsed.count());
+			};
+		measure(L"HeadlessVenue", [&] { return ReplayPlayer(replay).playToEnd(); });
+		measure(L"size-specialized", [&] { return replay.simulate(); });
+		return EXIT_SUCCESS;
+	}
+
+	// States are told apart by Venue::getStateHash(), so the counts are exact up to
+	// collisions of 64-bit hashes; a state seen again in the same game is a loop,
+	// one seen in an earlier game is a transposition.
+	int States(std::span<char* const> paths)
+	{
+		// replay index + 1 of the game the state was first seen in, every state is kept:
+		// TranspositionTable would forget states on collisions and count them again
+		std::unordered_map<uint64_t, uint32_t> seen;
+		size_t frames = 0, distinct = 0, loops = 0;
+		for (uint32_t index = 0; index < paths.size(); index++)
+		{
+			Replay replay = LoadReplay(paths[index]);
+			ReplayPlayer player(replay);
+			auto visit = [&]
+				{
+					frames++;
+					auto [first, inserted] = seen.try_emplace(player.getVenue().getStateHash(), index + 1);
+					if (inserted)
+						distinct++;
+					else
+						loops += first->second == index + 1;
+				};
+			for (visit(); player.step(); visit());
+		}
+		std::wprintf(L"%zu frames, %zu distinct states, %zu loops, %zu transpositions\n",
+					 frames, distinct, loops, frames - distinct - loops);
+		return EXIT_SUCCESS;
+	}
+
+	int Play(const Replay& replay, double frames_per_second)
+	{
+		ReplayPlayer player(replay);
+		auto& venue = player.getVenue();
+		const size_t height = venue.getHeight(), width = venue.getWidth();
+		FrameBuffer frame(width * 2, height);
+		AnsiTerminal terminal;
+		terminal.setCursorVisible(false);
+		terminal.clear();
+		FrameScheduler scheduler(std::chrono::duration_cast<FrameScheduler::Clock::duration>(
+			std::chrono::duration<double>(1.0 / frames_per_second)));
+
+		std::wstring text;
+		auto present = [&]
+			{
+				for (size_t y = 0; y < height; y++)
+					for (size_t x = 0; x < width; x++)
+						DrawElementCell(frame, x, y, venue.getPositionType(static_cast<uint8_t>(x), static_cast<uint8_t>(y)));
+				frame.present(
+					[&](size_t x, size_t y, std::span<const FrameCell> cells)
+					{
+						terminal.setCursor(static_cast<short>(x), static_cast<short>(y));
+						for (auto& cell : cells)
+						{
+							terminal.setColor(cell.color);
+							terminal.write(std::wstring_view(&cell.glyph, 1));
+						}
+					});
+				terminal.setColor(0x07);
+				terminal.setCursor(0, static_cast<short>(height));
+				text = L"frame " + std::to_wstring(venue.getTicks()) +
+					L"  score " + std::to_wstring(venue.getScore());
+				terminal.write(text);
+				terminal.flush();
+			};
+		present();
+		scheduler.restart();
+		while (!player.isFinished())
+		{
+			for (size_t due = scheduler.wait(); due != 0 && player.step(); due--);
+			present();
+		}
+		terminal.setCursorVisible(true);
+		terminal.write(L"\n");
+		return EXIT_SUCCESS;
+	}
+}
+
+int main(int argc, char* argv[]) try
+{
+	std::string command = argc > 1 ? argv[1] : "";
+	if (argc < 3 || (command != "record" && command != "bench" && command != "play" && command != "states"))
+	{
+		std::fwprintf(stderr, L"usage: SnakeReplay record|bench|play|states <file> [...]\n");
+		return EXIT_FAILURE;
+	}
+	if (command == "states")
+		return States({ argv + 2, argv + argc });
+	if (command == "record")
+	{
+		size_t size = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 15;
+		std::wstring map_name = argc > 4 && std::string(argv[4]) == "Space" ? L"Space" : L"Square";
+		uint64_t seed = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : GetRandomSeed();
+		return Record(argv[2], size, map_name, seed);
+	}
+	Replay replay = LoadReplay(argv[2]);
+	if (command == "bench")
+		return Bench(replay);
+	double frames_per_second = argc > 3 ? std::strtod(argv[3], nullptr) : 10.0;
+	return Play(replay, frames_per_second > 0 ? frames_per_second : 10.0);
+}
+catch (const Exception& error)
+{
+	std::fwprintf(stderr, L"%ls\n", error.what());
+	return EXIT_FAILURE;
+}
\ No newline at end of file
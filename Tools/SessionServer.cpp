@@ -0,0 +1,80 @@
+﻿#include "SessionServer.h"
+#include "ToolMaps.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cwchar>
+
+// usage:
+//     SnakeServer [unix:<path>] [tcp:<port>] [threads=<count>] [size=<map size>] [map=Square|Space] [speed=<1-10>]
+// Serves a game to each client until SIGINT or SIGTERM, e.g.
+//     socat -,raw,echo=0 UNIX-CONNECT:<path>
+//     telnet <host> <port>
+namespace
+{
+	SessionServer* running_server = nullptr;
+
+	void OnSignal(int)
+	{
+		if (running_server)
+			running_server->stop();
+	}
+}
+
+int main(int argc, char* argv[]) try
+{
+	std::vector<std::string> unix_paths;
+	std::vector<uint16_t> ports;
+	size_t threads = 0, size = 15;
+	std::wstring map_name = L"Square";
+	int speed = 7;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		auto value = [&](const char* prefix) { return option.substr(std::char_traits<char>::length(prefix)); };
+		if (option.starts_with("unix:"))
+			unix_paths.push_back(value("unix:"));
+		else if (option.starts_with("tcp:"))
+			ports.push_back(static_cast<uint16_t>(std::strtoul(value("tcp:").c_str(), nullptr, 10)));
+		else if (option.starts_with("threads="))
+			threads = std::strtoull(value("threads=").c_str(), nullptr, 10);
+		else if (option.starts_with("size="))
+			size = std::clamp<size_t>(std::strtoull(value("size=").c_str(), nullptr, 10), 5, 100);
+		else if (option.starts_with("map="))
+			map_name = value("map=") == "Space" ? L"Space" : L"Square";
+		else if (option.starts_with("speed="))
+			speed = std::clamp(std::atoi(value("speed=").c_str()), 1, 10);
+		else
+		{
+			std::fwprintf(stderr, L"usage: SnakeServer [unix:<path>] [tcp:<port>] [threads=<count>] "
+						  L"[size=<map size>] [map=Square|Space] [speed=<1-10>]\n");
+			return EXIT_FAILURE;
+		}
+	}
+	if (unix_paths.empty() && ports.empty())
+		unix_paths.push_back("snake.sock");
+
+	SessionServer server({ MakeToolMap(map_name, size), speed }, threads);
+	for (auto& path : unix_paths)
+		server.listenUnix(path);
+	for (auto port : ports)
+		server.listenTcp(port);
+	running_server = &server;
+	std::signal(SIGINT, OnSignal);
+	std::signal(SIGTERM, OnSignal);
+	std::fwprintf(stderr, L"serving with %zu threads\n", server.getThreadCount());
+	server.run();
+	running_server = nullptr;
+	return EXIT_SUCCESS;
+}
+catch (const Exception& error)
+{
+	std::fwprintf(stderr, L"%ls\n", error.what());
+	return EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+﻿#include "HeadlessVenue.h"
+#include "VenueSnapshot.h"
+#include "ToolMaps.h"
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cwchar>
+
+namespace
+{
+	constexpr Direction Moves[] = { Direction::Up, Direction::Left, Direction::Right, Direction::Down };
+
+	template<typename VenueType>
+	void Measure(const wchar_t* storage, const DynArray<MapNode, 2>& map, size_t cycles)
+	{
+		VenueType venue(map, 1);
+		SnapshotArena arena(venue.getSnapshotSize());
+		auto root = arena.acquire();
+		venue.snapshot(root);
+
+		// snapshot only
+		auto begin = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < cycles; i++)
+		{
+			auto slot = arena.acquire();
+			venue.snapshot(slot);
+			arena.release(slot);
+		}
+		std::chrono::duration<double> snapshot_time = std::chrono::steady_clock::now() - begin;
+
+		// clone, step and discard
+		size_t sink = 0;
+		begin = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < cycles; i++)
+		{
+			auto slot = arena.acquire();
+			venue.snapshot(slot);
+			sink += venue.step(Moves[i & 3]).count;
+			venue.restore(slot);
+			arena.release(slot);
+		}
+		std::chrono::duration<double> cycle_time = std::chrono::steady_clock::now() - begin;
+		arena.release(root);
+
+		std::wprintf(L"%-6zu %-8ls %10zu %16.0f %16.0f (sink %zu)\n", map.size(0), storage, venue.getSnapshotSize(),
+					 cycles / snapshot_time.count(), cycles / cycle_time.count(), sink & 0xF);
+	}
+
+	template<size_t Size>
+	void MeasureSize(std::wstring_view map_name, size_t cycles)
+	{
+		auto map = MakeToolMap(map_name, Size);
+		Measure<HeadlessVenue>(L"packed", map, cycles);
+		Measure<BasicHeadlessVenue<CellPlanes>>(L"planes", map, cycles);
+		Measure<FixedHeadlessVenue<Size>>(L"fixed", map, cycles);
+	}
+} // namespace
+
+// Clone-step-discard cycles as tree search does them, on the preset map sizes.
+// usage: SnakeSnapshotBenchmark [cycles] [Square|Space]
+int main(int argc, char* argv[])
+{
+	size_t cycles = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	std::wstring map_name = argc > 2 && std::string(argv[2]) == "Space" ? L"Space" : L"Square";
+
+	std::wprintf(L"%ls maps, %zu cycles\n", map_name.c_str(), cycles);
+	std::wprintf(L"%-6ls %-8ls %10ls %16ls %16ls\n", L"size", L"storage", L"bytes", L"snapshots/s", L"cycles/s");
+	MeasureSize<15>(map_name, cycles);
+	MeasureSize<20>(map_name, cycles);
+	MeasureSize<24>(map_name, cycles);
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+﻿#include "MultiSnakeVenue.h"
+#include "FastRandom.h"
+#include "ToolMaps.h"
+
+#include <chrono>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cwchar>
+
+namespace
+{
+	constexpr Direction::Tags Candidates[] =
+	{ Direction::Up, Direction::Left, Direction::Right, Direction::Down };
+
+	// Cheap autopilot: food next to the head first, then mostly straight on, avoiding bodies.
+	Direction ChooseDirection(const MultiSnakeVenue& venue, const MultiSnakeVenue::Snake& snake, FastRandom& random)
+	{
+		Direction safe[4];
+		size_t safe_count = 0;
+		bool straight_safe = false;
+		for (Direction direct : Candidates)
+		{
+			if (direct.isConflictWith(snake.direct))
+				continue;
+			auto type = venue.getCell(venue.getAdjacentPosition(snake.head, direct)).type;
+			if (type == Element::Food)
+				return direct;
+			if (type == Element::Blank)
+			{
+				safe[safe_count++] = direct;
+				straight_safe = straight_safe || direct == snake.direct;
+			}
+		}
+		if (safe_count == 0)
+			return snake.direct;
+		if (straight_safe && random.bounded(8) != 0)
+			return snake.direct;
+		return safe[random.bounded(static_cast<uint32_t>(safe_count))];
+	}
+} // namespace
+
+// Ticks per second of crowded maps, dead snakes are replaced at once.
+// usage: SnakeSwarmBenchmark [ticks] [map size] [Square|Space] [seed]
+int main(int argc, char* argv[])
+{
+	size_t ticks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+	size_t size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 255;
+	std::wstring map_name = argc > 3 && std::string(argv[3]) == "Square" ? L"Square" : L"Space";
+	uint64_t seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+	constexpr size_t SnakeLength = 5;
+
+	std::wprintf(L"%ls %zux%zu, %zu ticks\n", map_name.c_str(), size, size, ticks);
+	std::wprintf(L"%-8ls %12ls %14ls %10ls %10ls\n", L"snakes", L"ticks/s", L"moves/s", L"deaths", L"meals");
+	for (size_t count : { 16, 64, 256, 1024, 4096 })
+	{
+		MultiSnakeVenue venue(MakeToolMap(map_name, size), count / 2 + 1, seed);
+		FastRandom random(seed);
+		for (size_t i = 0; i < count; i++)
+			venue.spawnSnake(SnakeLength);
+
+		size_t moves = 0, deaths = 0, meals = 0;
+		auto begin = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < ticks; i++)
+		{
+			for (uint32_t id = 0; id < venue.getSnakeCount(); id++)
+			{
+				auto& snake = venue.getSnake(id);
+				if (snake.alive)
+					venue.orderDirection(id, ChooseDirection(venue, snake, random));
+			}
+			moves += venue.getAliveCount();
+			auto result = venue.tick();
+			deaths += result.deaths;
+			meals += result.meals;
+			while (venue.getAliveCount() < count && venue.spawnSnake(SnakeLength))
+				continue;
+		}
+		std::chrono::duration<double> time = std::chrono::steady_clock::now() - begin;
+
+		std::wprintf(L"%-8zu %12.0f %14.0f %10zu %10zu\n", count, ticks / time.count(),
+					 moves / time.count(), deaths, meals);
+	}
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+﻿#pragma once
+#ifndef SNAKE_TOOLMAPS_HEADER_
+#define SNAKE_TOOLMAPS_HEADER_
+
+#include "Venue.h"
+#include "Pythonic.h"
+#include <string_view>
+#include <cstddef>
+
+// The built-in maps "Square" and "Space", without depending on Resource.h.
+inline DynArray<MapNode, 2> MakeToolMap(std::wstring_view name, size_t size)
+{
+	DynArray<MapNode, 2> map(size, size);
+	bool square = name == L"Square";
+	for (auto y : range(size))
+	{
+		for (auto x : range(size))
+		{
+			bool border = x == 0 || y == 0 || x == size - 1 || y == size - 1;
+			map[y][x].type = square && border ? Element::Barrier : Element::Blank;
+		}
+	}
+	return map;
+}
+
+#endif // SNAKE_TOOLMAPS_HEADER_
\ No newline at end of file
@@ -0,0 +1,35 @@
+﻿#include "Tournament.h"
+#include "HamiltonSolver.h"
+#include "ToolMaps.h"
+
+#include <memory>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+
+// usage: SnakeTournament [games per solver] [map size] [Square|Space] [threads] [seed]
+int main(int argc, char* argv[])
+{
+	size_t games = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+	size_t size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 15;
+	std::wstring map_name = argc > 3 && std::string(argv[3]) == "Space" ? L"Space" : L"Square";
+	size_t threads = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 0;
+
+	Tournament tournament(MakeToolMap(map_name, size), games, threads);
+	if (argc > 5)
+		tournament.setSeed(std::strtoull(argv[5], nullptr, 10));
+	tournament.addSolver([] { return std::make_unique<GreedySolver>(); });
+	// cycles are found once for all games, and not written to the disk
+	static CycleCache cycles(std::nullopt);
+	tournament.addSolver([] { return std::make_unique<HamiltonSolver>(cycles); });
+
+	std::wprintf(L"%ls %zux%zu, %zu games per solver\n", map_name.c_str(), size, size, games);
+	std::wprintf(L"%-12ls %10ls %10ls %14ls\n", L"solver", L"avg score", L"win rate", L"moves/s");
+	for (auto& result : tournament.run())
+	{
+		std::wprintf(L"%-12ls %10.2f %9.2f%% %14.0f\n", result.solver_name.c_str(),
+					 result.averageScore(), result.winRate() * 100, result.movesPerSecond());
+	}
+	return EXIT_SUCCESS;
+}
\ No newline at end of file